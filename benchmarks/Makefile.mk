@@ -8,6 +8,8 @@ check_PROGRAMS += benchmarks/ping-pong          \
                   benchmarks/strided-bench      \
                   benchmarks/bench_groups       \
                   benchmarks/rmw_perf           \
+                  benchmarks/scale-bench        \
+                  benchmarks/nb-aggregate-bench \
                   # end
 
 TESTS          += benchmarks/ping-pong          \
@@ -15,6 +17,8 @@ TESTS          += benchmarks/ping-pong          \
                   benchmarks/contiguous-bench   \
                   benchmarks/strided-bench      \
                   benchmarks/rmw_perf           \
+                  benchmarks/scale-bench        \
+                  benchmarks/nb-aggregate-bench \
                   # end
 
 benchmarks_ping_pong_LDADD = libarmci.la
@@ -23,3 +27,5 @@ benchmarks_contiguous_bench_LDADD = libarmci.la -lm
 benchmarks_strided_bench_LDADD = libarmci.la -lm
 benchmarks_bench_groups_LDADD = libarmci.la -lm
 benchmarks_rmw_perf_LDADD = libarmci.la
+benchmarks_scale_bench_LDADD = libarmci.la
+benchmarks_nb_aggregate_bench_LDADD = libarmci.la
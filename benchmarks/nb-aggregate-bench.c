@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <mpi.h>
+#include <armci.h>
+
+#define MAX_BATCH       4096
+#define XFER_SIZE       sizeof(double)
+#define NUM_ITERATIONS  ((batch <= 64) ? 1000 : 100)
+#define NUM_WARMUP_ITER 10
+
+/* Issue batches of small nonblocking puts, gets and accumulates on one
+ * aggregate handle and complete each batch with a single ARMCI_Wait.  This
+ * measures the per operation cost of aggregating operations on a handle. */
+
+int main(int argc, char ** argv) {
+  int     rank, nproc, target_rank, batch, test_iter, i;
+  double *buf;
+  void  **base_ptrs;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nproc);
+
+  if (rank == 0) printf("Starting nonblocking aggregate handle test with %d processes\n", nproc);
+
+  buf = ARMCI_Malloc_local(MAX_BATCH*XFER_SIZE);
+  base_ptrs = malloc(sizeof(void*)*nproc);
+  ARMCI_Malloc(base_ptrs, MAX_BATCH*XFER_SIZE);
+
+  for (i = 0; i < MAX_BATCH; i++)
+    buf[i] = rank;
+
+  ARMCI_Barrier();
+
+  if (rank == 0)
+    printf("%12s %12s %16s %16s %16s\n", "Trg. Rank", "Batch", "NbPut (usec/op)", "NbGet (usec/op)",
+           "NbAcc (usec/op)");
+
+  target_rank = (nproc > 1) ? 1 : 0;
+
+  for (batch = 1; rank == 0 && batch <= MAX_BATCH; batch *= 4) {
+    double t_put = 0, t_get = 0, t_acc = 0, scale = 1.0;
+
+    for (test_iter = 0; test_iter < NUM_ITERATIONS + NUM_WARMUP_ITER; test_iter++) {
+      armci_hdl_t handle;
+
+      if (test_iter == NUM_WARMUP_ITER)
+        t_put = MPI_Wtime();
+
+      ARMCI_INIT_HANDLE(&handle);
+      ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+      for (i = 0; i < batch; i++)
+        ARMCI_NbPut(&buf[i], ((double*)base_ptrs[target_rank]) + i, XFER_SIZE, target_rank, &handle);
+
+      ARMCI_Wait(&handle);
+      ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+    }
+    t_put = (MPI_Wtime() - t_put)/NUM_ITERATIONS/batch;
+
+    for (test_iter = 0; test_iter < NUM_ITERATIONS + NUM_WARMUP_ITER; test_iter++) {
+      armci_hdl_t handle;
+
+      if (test_iter == NUM_WARMUP_ITER)
+        t_get = MPI_Wtime();
+
+      ARMCI_INIT_HANDLE(&handle);
+      ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+      for (i = 0; i < batch; i++)
+        ARMCI_NbGet(((double*)base_ptrs[target_rank]) + i, &buf[i], XFER_SIZE, target_rank, &handle);
+
+      ARMCI_Wait(&handle);
+      ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+    }
+    t_get = (MPI_Wtime() - t_get)/NUM_ITERATIONS/batch;
+
+    for (test_iter = 0; test_iter < NUM_ITERATIONS + NUM_WARMUP_ITER; test_iter++) {
+      armci_hdl_t handle;
+
+      if (test_iter == NUM_WARMUP_ITER)
+        t_acc = MPI_Wtime();
+
+      ARMCI_INIT_HANDLE(&handle);
+      ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+      for (i = 0; i < batch; i++)
+        ARMCI_NbAcc(ARMCI_ACC_DBL, &scale, &buf[i], ((double*)base_ptrs[target_rank]) + i, XFER_SIZE, target_rank, &handle);
+
+      ARMCI_Wait(&handle);
+      ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+    }
+    t_acc = (MPI_Wtime() - t_acc)/NUM_ITERATIONS/batch;
+
+    printf("%12d %12d %16.3f %16.3f %16.3f\n", target_rank, batch, t_put*1.0e6, t_get*1.0e6, t_acc*1.0e6);
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Free(base_ptrs[rank]);
+  ARMCI_Free_local(buf);
+  free(base_ptrs);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return 0;
+}
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <mpi.h>
+#include <armci.h>
+#include <armci_internals.h>
+
+#define MAX_DATA_SIZE   (1024*1024)
+#define MIN_DATA_SIZE   48   /* Not a power of two, to exercise the kernel tails */
+#define NUM_ITERATIONS  ((data_size <= 16384) ? 4096 : 256)
+#define NUM_WARMUP_ITER 4
+
+/* Compare the accumulate scaling kernels at each SIMD level supported by this
+ * CPU against the portable (NONE) kernels.  Throughput counts the bytes read
+ * plus the bytes written.  Outputs must match the portable kernels bitwise. */
+
+static const char *type_names[] = { "int", "long", "float", "double", "complex", "dcomplex" };
+
+int main(int argc, char ** argv) {
+  int    rank, datatype, data_size, test_iter, errors = 0;
+  enum   ARMCII_Simd_levels_e level, max_level;
+  void  *src, *dst, *ref;
+  union { int i; long l; float f; double d; float c[2]; double z[2]; } scale;
+  size_t i;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+
+  max_level = ARMCII_Simd_detect();
+
+  if (rank == 0) printf("Starting accumulate scaling kernel test, SIMD = %s\n",
+                        ARMCII_Simd_levels_str[max_level]);
+
+  src = ARMCI_Malloc_local(MAX_DATA_SIZE);
+  dst = ARMCI_Malloc_local(MAX_DATA_SIZE);
+  ref = ARMCI_Malloc_local(MAX_DATA_SIZE);
+
+  for (datatype = ARMCI_ACC_INT; rank == 0 && datatype <= ARMCI_ACC_DCP; datatype++) {
+    int type_size;
+
+    /* Fill the source with small values so integer products don't overflow */
+    switch (datatype) {
+      case ARMCI_ACC_INT:
+        for (i = 0; i < MAX_DATA_SIZE/sizeof(int); i++) ((int*)src)[i] = i % 1000 - 500;
+        scale.i = 3;
+        break;
+      case ARMCI_ACC_LNG:
+        for (i = 0; i < MAX_DATA_SIZE/sizeof(long); i++) ((long*)src)[i] = i % 1000 - 500;
+        scale.l = -7;
+        break;
+      case ARMCI_ACC_FLT:
+      case ARMCI_ACC_CPL:
+        for (i = 0; i < MAX_DATA_SIZE/sizeof(float); i++) ((float*)src)[i] = 1.0f/(i+1);
+        scale.c[0] = 1.5f;
+        scale.c[1] = -0.3f;
+        break;
+      case ARMCI_ACC_DBL:
+      case ARMCI_ACC_DCP:
+        for (i = 0; i < MAX_DATA_SIZE/sizeof(double); i++) ((double*)src)[i] = 1.0/(i+1);
+        scale.z[0] = 1.5;
+        scale.z[1] = -0.3;
+        break;
+    }
+
+    printf("\n%s\n%12s", type_names[datatype], "Size");
+    for (level = ARMCII_SIMD_NONE; level <= max_level; level++)
+      printf(" %8s GB/s", ARMCII_Simd_levels_str[level]);
+    printf("\n");
+
+    for (data_size = MIN_DATA_SIZE; data_size <= MAX_DATA_SIZE; data_size *= 4) {
+      printf("%12d", data_size);
+
+      for (level = ARMCII_SIMD_NONE; level <= max_level; level++) {
+        ARMCII_Scale_fn_t kernel = ARMCII_Scale_kernel_level(datatype, level, &type_size);
+        double t = 0;
+
+        for (test_iter = 0; test_iter < NUM_ITERATIONS + NUM_WARMUP_ITER; test_iter++) {
+          if (test_iter == NUM_WARMUP_ITER)
+            t = MPI_Wtime();
+
+          kernel(src, dst, data_size/type_size, &scale);
+        }
+        t = (MPI_Wtime() - t)/NUM_ITERATIONS;
+
+        printf(" %13.3f", 2.0*data_size/t/1.0e9);
+
+        if (level == ARMCII_SIMD_NONE) {
+          memcpy(ref, dst, data_size);
+        } else if (memcmp(ref, dst, data_size) != 0) {
+          printf("\nError: %s kernel output differs from NONE for %s, size %d\n",
+                 ARMCII_Simd_levels_str[level], type_names[datatype], data_size);
+          errors++;
+        }
+      }
+      printf("\n");
+    }
+  }
+
+  ARMCI_Free_local(src);
+  ARMCI_Free_local(dst);
+  ARMCI_Free_local(ref);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  return errors != 0;
+}
@@ -0,0 +1,493 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include <armci.h>
+#include <armci_internals.h>
+#include <debug.h>
+#include <gmr.h>
+
+/* Aggregate handles: Small contiguous puts and accumulates issued on a handle
+ * marked with ARMCI_SET_AGGREGATE_HANDLE are copied (and scaled) into a
+ * staging buffer owned by the handle instead of being issued.  Operations of
+ * the same kind to the same target form a batch, and each batch is issued as
+ * one I/O vector operation, so that the IOV engine can coalesce adjacent
+ * segments or describe them with a single indexed datatype.  Batches are
+ * issued when the handle is waited on or tested, or when the staging buffer
+ * or the batch table fills.
+ *
+ * The staging area of a handle is only reused once the handle completes, so
+ * issued batches never need to be waited on individually.  Aggregation state
+ * is cached per thread, so a handle that is used repeatedly doesn't allocate
+ * in steady state.  Nonblocking operations whose operands must outlive the
+ * call can keep them in the staging area of any handle. */
+
+#define ARMCII_AGG_MAX_BATCHES 64  /* Open batches per handle (distinct targets and operations) */
+#define ARMCII_AGG_MIN_SEGS    64  /* Initial length of a batch's segment arrays                 */
+#define ARMCII_AGG_CACHE_DEPTH 4   /* Aggregation states kept per thread                         */
+
+typedef struct {
+  enum ARMCII_Op_e op;        /* ARMCII_OP_PUT or ARMCII_OP_ACC                                  */
+  int          datatype;      /* ARMCI accumulate datatype                                       */
+  int          proc;          /* Target process                                                  */
+  gmr_t       *mreg;          /* Allocation of the first segment                                 */
+  int          same_alloc;    /* All segments fall within mreg                                   */
+  int          same_size;     /* All segments are size bytes long                                */
+  int          ascending;     /* Segments are disjoint and in increasing remote address order    */
+  int          size;
+  uint8_t     *rem_end;       /* End of the last segment at the target                           */
+  int          count;         /* Number of segments                                              */
+  int          max_count;     /* Length of the segment arrays                                    */
+  void       **loc;           /* Staged origin of each segment                                   */
+  void       **rem;           /* Target of each segment                                          */
+  int         *sizes;         /* Length of each segment                                          */
+} armcii_agg_batch_t;
+
+struct armcii_agg_s {
+  armcii_agg_batch_t   batches[ARMCII_AGG_MAX_BATCHES];
+  int                  nbatches;  /* Open batches, in the order they were started          */
+  int                  last;      /* Most recently used batch                              */
+  uint8_t             *buf;       /* Staging buffer                                        */
+  size_t               buf_used;
+  void               **retired;   /* Full staging buffers whose batches are in flight      */
+  int                  nretired;
+  int                  max_retired;
+  struct armcii_agg_s *next;      /* Free list link                                        */
+};
+
+static ARMCII_THREAD_LOCAL armcii_agg_t *agg_cache;
+static ARMCII_THREAD_LOCAL int           agg_cache_count;
+
+
+/** Is it safe to use the aggregation state cache from this thread?  Without
+  * thread-local storage the cache is shared by all threads.
+  */
+static inline int ARMCII_Agg_cache_usable(void) {
+#if ARMCII_HAVE_THREAD_LOCAL
+  return 1;
+#else
+  return ARMCII_GLOBAL_STATE.thread_level != MPI_THREAD_MULTIPLE;
+#endif
+}
+
+
+/** Get an empty aggregation state.
+  */
+static armcii_agg_t *ARMCII_Agg_alloc(void) {
+  armcii_agg_t *agg;
+
+  if (ARMCII_Agg_cache_usable() && agg_cache != NULL) {
+    agg       = agg_cache;
+    agg_cache = agg->next;
+    agg_cache_count--;
+    return agg;
+  }
+
+  agg = calloc(1, sizeof(armcii_agg_t));
+  ARMCII_Assert(agg != NULL);
+
+  agg->buf = malloc(ARMCII_GLOBAL_STATE.agg_bufsize);
+  ARMCII_Assert(agg->buf != NULL);
+
+  return agg;
+}
+
+
+/** Free an aggregation state and everything it owns.
+  */
+static void ARMCII_Agg_destroy(armcii_agg_t *agg) {
+  int i;
+
+  for (i = 0; i < ARMCII_AGG_MAX_BATCHES; i++) {
+    free(agg->batches[i].loc);
+    free(agg->batches[i].rem);
+    free(agg->batches[i].sizes);
+  }
+
+  for (i = 0; i < agg->nretired; i++)
+    free(agg->retired[i]);
+
+  free(agg->retired);
+  free(agg->buf);
+  free(agg);
+}
+
+
+/** Keep a staging buffer alive until the handle completes.
+  */
+static void ARMCII_Agg_retire(armcii_agg_t *agg, void *buf) {
+  if (agg->nretired == agg->max_retired) {
+    agg->max_retired = (agg->max_retired == 0) ? 4 : 2*agg->max_retired;
+    agg->retired     = realloc(agg->retired, agg->max_retired*sizeof(void*));
+    ARMCII_Assert(agg->retired != NULL);
+  }
+
+  agg->retired[agg->nretired++] = buf;
+}
+
+
+/** Find the open batch for an operation, or start one.  Returns NULL when
+  * the batch table is full.
+  */
+static armcii_agg_batch_t *ARMCII_Agg_find_batch(armcii_agg_t *agg, enum ARMCII_Op_e op, int datatype, int proc) {
+  armcii_agg_batch_t *b;
+  int i;
+
+  /* Consecutive operations usually go to the same batch */
+  if (agg->nbatches > 0) {
+    b = &agg->batches[agg->last];
+    if (b->proc == proc && b->op == op && b->datatype == datatype)
+      return b;
+  }
+
+  for (i = 0; i < agg->nbatches; i++) {
+    b = &agg->batches[i];
+    if (b->proc == proc && b->op == op && b->datatype == datatype) {
+      agg->last = i;
+      return b;
+    }
+  }
+
+  if (agg->nbatches == ARMCII_AGG_MAX_BATCHES)
+    return NULL;
+
+  agg->last = agg->nbatches++;
+
+  b = &agg->batches[agg->last];
+  b->op       = op;
+  b->datatype = datatype;
+  b->proc     = proc;
+  b->count    = 0;
+
+  return b;
+}
+
+
+/** Issue one batch on the handle.
+  */
+static void ARMCII_Agg_issue_batch(armcii_agg_batch_t *b, armci_hdl_t *handle) {
+  int overlapping;
+
+  if (b->count == 0)
+    return;
+
+  ARMCII_Dbg_print(DEBUG_CAT_IOV, "issuing aggregate batch of %d %s operations to %d\n",
+                   b->count, b->op == ARMCII_OP_PUT ? "put" : "acc", b->proc);
+
+  /* Operations queued in increasing address order can't overlap; otherwise
+   * check, regardless of ARMCI_IOV_CHECKS, since the user didn't promise
+   * anything about this vector. */
+  if (b->ascending)
+    overlapping = 0;
+  else
+    overlapping = ARMCII_Iov_check_overlap_always(b->rem, b->count, b->same_size ? b->size : 0,
+                                                  b->same_size ? NULL : b->sizes);
+
+  if (overlapping) {
+    /* Overlapping segments are issued one at a time, in the order they were
+     * queued, like they would have been without aggregation */
+    MPI_Datatype type;
+    int i, type_size = 1;
+
+    if (b->op == ARMCII_OP_ACC)
+      ARMCII_Acc_type_translate(b->datatype, &type, &type_size);
+
+    for (i = 0; i < b->count; i++) {
+      gmr_t *mreg = b->same_alloc ? b->mreg : gmr_lookup(b->rem[i], b->proc);
+
+      if (b->op == ARMCII_OP_PUT)
+        gmr_put(mreg, b->loc[i], b->rem[i], b->sizes[i], b->proc, handle);
+      else
+        gmr_accumulate(mreg, b->loc[i], b->rem[i], b->sizes[i]/type_size, type, b->proc, handle);
+    }
+  }
+  else if (b->same_size) {
+    ARMCII_Iov_op_dispatch(b->op, b->loc, b->rem, b->count, b->size, b->datatype,
+                           0 /* not overlapping */, b->same_alloc, b->proc, 0 /* nonblocking */, handle);
+  }
+  else {
+    ARMCII_Iov_op_dispatch_vl(b->op, b->loc, b->rem, b->count, b->sizes, b->datatype,
+                              0 /* not overlapping */, b->same_alloc, b->proc, 0 /* nonblocking */, handle);
+  }
+
+  b->count = 0;
+}
+
+
+/** Issue all open batches on the handle.  The staging buffer stays in use
+  * until the handle completes.
+  */
+static void ARMCII_Agg_issue_all(armcii_agg_t *agg, armci_hdl_t *handle) {
+  int i;
+
+  for (i = 0; i < agg->nbatches; i++)
+    ARMCII_Agg_issue_batch(&agg->batches[i], handle);
+
+  agg->nbatches = 0;
+  agg->last     = 0;
+}
+
+
+/** Make room for bytes at the given alignment in the handle's staging
+  * buffer, creating the aggregation state if needed.  A full buffer is
+  * retired after its batches are issued.
+  */
+static void ARMCII_Agg_space(armci_hdl_t *handle, int bytes, int align) {
+  armcii_agg_t *agg;
+
+  if (handle->agg == NULL)
+    handle->agg = ARMCII_Agg_alloc();
+
+  agg = handle->agg;
+  agg->buf_used = (agg->buf_used + align - 1) & ~((size_t) align - 1);
+
+  if (agg->buf_used + bytes > (size_t) ARMCII_GLOBAL_STATE.agg_bufsize) {
+    ARMCII_Agg_issue_all(agg, handle);
+
+    /* Batches issued from the full buffer may still be reading it */
+    ARMCII_Agg_retire(agg, agg->buf);
+
+    agg->buf      = malloc(ARMCII_GLOBAL_STATE.agg_bufsize);
+    agg->buf_used = 0;
+    ARMCII_Assert(agg->buf != NULL);
+  }
+}
+
+
+/** Reserve staging space for an operation on a handle, issuing the open
+  * batches when the staging buffer or the batch table is full.
+  *
+  * @param[in]  handle   Aggregate handle
+  * @param[in]  op       Operation
+  * @param[in]  datatype Accumulate datatype
+  * @param[in]  bytes    Staging space needed
+  * @param[in]  align    Alignment of the staging space (a power of two)
+  * @param[in]  proc     Target process
+  * @param[out] b_out    Batch to append the operation to
+  * @return              Staging space for the operation
+  */
+static void *ARMCII_Agg_reserve(armci_hdl_t *handle, enum ARMCII_Op_e op, int datatype, int bytes,
+                                int align, int proc, armcii_agg_batch_t **b_out)
+{
+  armcii_agg_t *agg;
+  armcii_agg_batch_t *b;
+  void *stage;
+
+  /* Accumulate segments are aligned to their element size.  Consecutive
+   * segments of a batch stay contiguous in the staging buffer, so the IOV
+   * engine can merge them when they are also contiguous at the target. */
+  ARMCII_Agg_space(handle, bytes, align);
+
+  agg = handle->agg;
+  b   = ARMCII_Agg_find_batch(agg, op, datatype, proc);
+
+  if (b == NULL) {
+    ARMCII_Agg_issue_all(agg, handle);
+    b = ARMCII_Agg_find_batch(agg, op, datatype, proc);
+  }
+
+  if (b->count == b->max_count) {
+    b->max_count = (b->max_count == 0) ? ARMCII_AGG_MIN_SEGS : 2*b->max_count;
+    b->loc       = realloc(b->loc,   b->max_count*sizeof(void*));
+    b->rem       = realloc(b->rem,   b->max_count*sizeof(void*));
+    b->sizes     = realloc(b->sizes, b->max_count*sizeof(int));
+    ARMCII_Assert(b->loc != NULL && b->rem != NULL && b->sizes != NULL);
+  }
+
+  stage = agg->buf + agg->buf_used;
+  agg->buf_used += bytes;
+
+  *b_out = b;
+  return stage;
+}
+
+
+/** Append a staged segment to a batch.
+  */
+static void ARMCII_Agg_append(armcii_agg_batch_t *b, gmr_t *mreg, void *stage, void *dst, int bytes) {
+  const int i = b->count++;
+
+  if (i == 0) {
+    b->mreg       = mreg;
+    b->same_alloc = 1;
+    b->same_size  = 1;
+    b->ascending  = 1;
+    b->size       = bytes;
+  } else {
+    if (mreg != b->mreg)
+      b->same_alloc = 0;
+    if (bytes != b->size)
+      b->same_size = 0;
+    if ((uint8_t*) dst < b->rem_end)
+      b->ascending = 0;
+  }
+
+  b->loc[i]   = stage;
+  b->rem[i]   = dst;
+  b->sizes[i] = bytes;
+  b->rem_end  = ((uint8_t*) dst) + bytes;
+}
+
+
+/** Queue a put on an aggregate handle.  The source is copied without the
+  * shared buffer guard, so it must be in private memory.
+  *
+  * @param[in] handle Handle, may be NULL
+  * @param[in] mreg   Allocation containing dst
+  * @param[in] src    Source buffer
+  * @param[in] dst    Destination buffer on proc
+  * @param[in] bytes  Length of the transfer
+  * @param[in] proc   Target process
+  * @return           1 if the put was queued, 0 if the caller must issue it
+  */
+int ARMCII_Agg_put(armci_hdl_t *handle, struct gmr_s *mreg, void *src, void *dst, int bytes, int proc) {
+  armcii_agg_batch_t *b;
+  void *stage;
+
+  if (handle == NULL || !handle->aggregate || bytes <= 0 || bytes > ARMCII_GLOBAL_STATE.agg_limit)
+    return 0;
+
+  stage = ARMCII_Agg_reserve(handle, ARMCII_OP_PUT, 0, bytes, 1, proc, &b);
+  memcpy(stage, src, bytes);
+  ARMCII_Agg_append(b, mreg, stage, dst, bytes);
+
+  return 1;
+}
+
+
+/** Queue an accumulate on an aggregate handle.  Scaling is applied while
+  * staging.  As with ARMCII_Agg_put, the source must be in private memory.
+  *
+  * @param[in] handle   Handle, may be NULL
+  * @param[in] mreg     Allocation containing dst
+  * @param[in] datatype ARMCI accumulate datatype
+  * @param[in] scale    Scaling factor
+  * @param[in] src      Source buffer
+  * @param[in] dst      Destination buffer on proc
+  * @param[in] bytes    Length of the transfer
+  * @param[in] proc     Target process
+  * @return             1 if the accumulate was queued, 0 if the caller must issue it
+  */
+int ARMCII_Agg_acc(armci_hdl_t *handle, struct gmr_s *mreg, int datatype, void *scale,
+                   void *src, void *dst, int bytes, int proc)
+{
+  armcii_agg_batch_t *b;
+  MPI_Datatype type;
+  int type_size;
+  void *stage;
+
+  if (handle == NULL || !handle->aggregate || bytes <= 0 || bytes > ARMCII_GLOBAL_STATE.agg_limit)
+    return 0;
+
+  ARMCII_Acc_type_translate(datatype, &type, &type_size);
+  ARMCII_Assert_msg(bytes % type_size == 0, "Transfer size is not a multiple of the datatype size");
+
+  stage = ARMCII_Agg_reserve(handle, ARMCII_OP_ACC, datatype, bytes, type_size, proc, &b);
+
+  if (ARMCII_Buf_acc_is_scaled(datatype, scale))
+    ARMCII_Buf_acc_scale(src, stage, bytes, datatype, scale);
+  else
+    memcpy(stage, src, bytes);
+
+  ARMCII_Agg_append(b, mreg, stage, dst, bytes);
+
+  return 1;
+}
+
+
+/** Reserve space owned by a handle until it completes, e.g. for the operands
+  * of nonblocking operations issued on it.  Works on any handle.
+  *
+  * @param[in] handle Handle
+  * @param[in] bytes  Size of the space
+  * @param[in] align  Alignment of the space (power of two)
+  * @return           Staging space
+  */
+void *ARMCII_Agg_stage(armci_hdl_t *handle, int bytes, int align) {
+  armcii_agg_t *agg;
+  void *stage;
+
+  ARMCII_Assert(handle != NULL);
+
+  /* Larger than a staging buffer: give it a buffer of its own */
+  if (bytes > ARMCII_GLOBAL_STATE.agg_bufsize) {
+    if (handle->agg == NULL)
+      handle->agg = ARMCII_Agg_alloc();
+
+    stage = malloc(bytes);
+    ARMCII_Assert(stage != NULL);
+    ARMCII_Agg_retire(handle->agg, stage);
+
+    return stage;
+  }
+
+  ARMCII_Agg_space(handle, bytes, align);
+
+  agg   = handle->agg;
+  stage = agg->buf + agg->buf_used;
+  agg->buf_used += bytes;
+
+  return stage;
+}
+
+
+/** Issue the operations queued on a handle.  They are completed by the
+  * handle, and ARMCII_Agg_release must be called once it completes.
+  *
+  * @param[in] handle Handle
+  */
+void ARMCII_Agg_issue(armci_hdl_t *handle) {
+  if (handle->agg != NULL)
+    ARMCII_Agg_issue_all(handle->agg, handle);
+}
+
+
+/** Release the aggregation state of a handle whose operations have all
+  * completed.
+  *
+  * @param[in] handle Handle
+  */
+void ARMCII_Agg_release(armci_hdl_t *handle) {
+  armcii_agg_t *agg = handle->agg;
+  int i;
+
+  if (agg == NULL)
+    return;
+
+  ARMCII_Assert(agg->nbatches == 0);
+
+  for (i = 0; i < agg->nretired; i++)
+    free(agg->retired[i]);
+
+  agg->nretired = 0;
+  agg->buf_used = 0;
+  handle->agg   = NULL;
+
+  if (ARMCII_Agg_cache_usable() && agg_cache_count < ARMCII_AGG_CACHE_DEPTH) {
+    agg->next = agg_cache;
+    agg_cache = agg;
+    agg_cache_count++;
+  } else {
+    ARMCII_Agg_destroy(agg);
+  }
+}
+
+
+/** Free the calling thread's cached aggregation states.  Called by the thread
+  * that finalizes ARMCI; caches of other threads are reclaimed at process exit.
+  */
+void ARMCII_Agg_finalize(void) {
+  while (agg_cache != NULL) {
+    armcii_agg_t *agg = agg_cache;
+
+    agg_cache = agg->next;
+    ARMCII_Agg_destroy(agg);
+  }
+
+  agg_cache_count = 0;
+}
@@ -0,0 +1,170 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armci_internals.h>
+#include <debug.h>
+
+
+/* Scratch arena: A per-thread stack of temporary buffers used by the
+ * communication paths (e.g. IOV displacement arrays) in place of VLAs or
+ * repeated malloc/free.  Allocations must be released in LIFO order.  The
+ * backing block is only grown when the arena is empty; a request that doesn't
+ * fit while other scratch buffers are live falls back to malloc.  The demand
+ * at that point is remembered, and the next time the arena is empty it grows
+ * to hold it, so nested buffers stop falling back once they have done so. */
+
+#define ARMCII_ARENA_ALIGN    16
+#define ARMCII_ARENA_MIN_SIZE (64*1024)
+
+typedef struct {
+  size_t prev_used;     /* Arena offset before this allocation        */
+  size_t end;           /* Arena offset after this allocation, or the
+                           size of a heap allocation                  */
+  int    heap;          /* Allocation came from malloc                */
+} armcii_arena_hdr_t;
+
+#define ARMCII_ARENA_HDR_SIZE \
+  ((sizeof(armcii_arena_hdr_t) + ARMCII_ARENA_ALIGN - 1) & ~((size_t)ARMCII_ARENA_ALIGN - 1))
+
+typedef struct {
+  uint8_t      *base;
+  size_t        size;
+  size_t        used;
+  size_t        live;   /* Bytes of live buffers, including heap ones     */
+  size_t        peak;   /* Largest live demand that fell back to the heap */
+  unsigned long nheap;  /* Number of heap fallbacks                       */
+} armcii_arena_t;
+
+static ARMCII_THREAD_LOCAL armcii_arena_t ARMCII_Arena = { NULL, 0, 0, 0, 0, 0 };
+
+
+/** Is it safe to use the arena from this thread?  Without thread-local storage
+  * the arena is shared by all threads.
+  */
+static int ARMCII_Arena_usable(void) {
+#if ARMCII_HAVE_THREAD_LOCAL
+  return 1;
+#else
+  return ARMCII_GLOBAL_STATE.thread_level != MPI_THREAD_MULTIPLE;
+#endif
+}
+
+
+/** Allocate a scratch buffer.  The buffer is valid until it is released with
+  * ARMCII_Arena_free; buffers must be released in the reverse order they were
+  * allocated.
+  *
+  * @param[in] size Number of bytes
+  * @return         Pointer to the buffer, aligned to 16 bytes
+  */
+void *ARMCII_Arena_alloc(size_t size) {
+  armcii_arena_t     *arena = &ARMCII_Arena;
+  armcii_arena_hdr_t *hdr;
+  size_t              need, start;
+
+  size = (size + ARMCII_ARENA_ALIGN - 1) & ~((size_t)ARMCII_ARENA_ALIGN - 1);
+  need = ARMCII_ARENA_HDR_SIZE + size;
+
+  if (!ARMCII_Arena_usable()) {
+    hdr = malloc(need);
+    ARMCII_Assert(hdr != NULL);
+    hdr->end  = 0;
+    hdr->heap = 1;
+    return ((uint8_t*)hdr) + ARMCII_ARENA_HDR_SIZE;
+  }
+
+  /* Grow the block geometrically, only when no scratch buffers are live, to
+   * hold this request and the largest demand that didn't fit before */
+  if (arena->used == 0 && (need > arena->size || arena->peak > arena->size)) {
+    size_t new_size = (arena->size > 0) ? arena->size : ARMCII_ARENA_MIN_SIZE;
+
+    while (new_size < need || new_size < arena->peak)
+      new_size *= 2;
+
+    free(arena->base);
+    arena->base = malloc(new_size);
+    ARMCII_Assert(arena->base != NULL);
+    arena->size = new_size;
+  }
+
+  /* Doesn't fit behind the live buffers: fall back to the heap */
+  if (arena->used + need > arena->size) {
+    hdr = malloc(need);
+    ARMCII_Assert(hdr != NULL);
+    hdr->end  = need;
+    hdr->heap = 1;
+
+    arena->live += need;
+    arena->nheap++;
+    if (arena->live > arena->peak)
+      arena->peak = arena->live;
+
+    return ((uint8_t*)hdr) + ARMCII_ARENA_HDR_SIZE;
+  }
+
+  start          = arena->used;
+  hdr            = (armcii_arena_hdr_t*) (arena->base + start);
+  hdr->prev_used = start;
+  hdr->end       = start + need;
+  hdr->heap      = 0;
+  arena->used    = hdr->end;
+  arena->live   += need;
+
+  return ((uint8_t*)hdr) + ARMCII_ARENA_HDR_SIZE;
+}
+
+
+/** Release a scratch buffer.  Buffers must be released in the reverse order
+  * they were allocated.
+  *
+  * @param[in] ptr Buffer returned by ARMCII_Arena_alloc, or NULL
+  */
+void ARMCII_Arena_free(void *ptr) {
+  armcii_arena_t     *arena = &ARMCII_Arena;
+  armcii_arena_hdr_t *hdr;
+
+  if (ptr == NULL)
+    return;
+
+  hdr = (armcii_arena_hdr_t*) (((uint8_t*)ptr) - ARMCII_ARENA_HDR_SIZE);
+
+  if (hdr->heap) {
+    /* Zero when the arena isn't usable from this thread */
+    if (hdr->end > 0)
+      arena->live -= hdr->end;
+    free(hdr);
+    return;
+  }
+
+  ARMCII_Assert_msg(hdr->end == arena->used, "Scratch buffers released out of order");
+  arena->live -= hdr->end - hdr->prev_used;
+  arena->used  = hdr->prev_used;
+}
+
+
+/** Number of scratch buffers that the calling thread's arena could not hold
+  * and allocated with malloc instead.
+  */
+unsigned long ARMCII_Arena_heap_count(void) {
+  return ARMCII_Arena.nheap;
+}
+
+
+/** Release the calling thread's arena.  Called by the thread that finalizes
+  * ARMCI; arenas of other threads are reclaimed at process exit.
+  */
+void ARMCII_Arena_finalize(void) {
+  armcii_arena_t *arena = &ARMCII_Arena;
+
+  ARMCII_Assert_msg(arena->used == 0, "Scratch buffers are still in use");
+
+  free(arena->base);
+  arena->base = NULL;
+  arena->size = 0;
+  arena->peak = 0;
+}
@@ -2,8 +2,21 @@
  * Copyright (C) 2019. See COPYRIGHT in top-level directory.
  */
 
+#include <string.h>
+
 #include <armci.h>
 #include <armci_internals.h>
+#include <gmr.h>
+
+/* The device "shm_atomics" promises that atomics on the allocation only target
+ * processes on the caller's node, so they can use shared memory.  All other
+ * devices get a normal allocation. */
+static int ARMCII_Memdev_flags(const char *device) {
+  if (device != NULL && strcmp(device, "shm_atomics") == 0)
+    return GMR_SHM_ATOMICS;
+
+  return 0;
+}
 
 /* -- begin weak symbols block -- */
 #if defined(HAVE_PRAGMA_WEAK)
@@ -16,7 +29,7 @@
 /* -- end weak symbols block -- */
 int PARMCI_Malloc_memdev(void **ptr_arr, armci_size_t bytes, const char* device)
 {
-    return ARMCI_Malloc_group(ptr_arr, bytes, &ARMCI_GROUP_WORLD);
+    return ARMCII_Malloc_group(ptr_arr, bytes, &ARMCI_GROUP_WORLD, ARMCII_Memdev_flags(device));
 }
 
 /* -- begin weak symbols block -- */
@@ -30,7 +43,7 @@ int PARMCI_Malloc_memdev(void **ptr_arr, armci_size_t bytes, const char* device)
 /* -- end weak symbols block -- */
 int PARMCI_Malloc_group_memdev(void **ptr_arr, armci_size_t bytes, ARMCI_Group *group, const char *device)
 {
-    return ARMCI_Malloc_group(ptr_arr, bytes, group);
+    return ARMCII_Malloc_group(ptr_arr, bytes, group, ARMCII_Memdev_flags(device));
 }
 
 /* -- begin weak symbols block -- */
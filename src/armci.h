@@ -67,15 +67,35 @@ int   ARMCI_PutS_flag(void *src_ptr, int src_stride_ar[/*stride_levels*/],
                  int count[/*stride_levels+1*/], int stride_levels,
                  int *flag, int value, int proc);
 
+#ifndef USE_RMA_REQUESTS
+typedef struct armci_hdl_pair_s
+{
+    MPI_Win win;
+    int target;    /* rank in the window's group */
+}
+armci_hdl_pair_t;
+#endif
+
+#ifdef USE_RMA_REQUESTS
+#define ARMCI_HDL_INLINE_REQUESTS 4
+#endif
+
+struct armcii_agg_s;
+
 typedef struct armci_hdl_s
 {
+    int aggregate;                // set by ARMCI_SET_AGGREGATE_HANDLE
+    struct armcii_agg_s *agg;     // small operations queued on an aggregate handle
+    MPI_Request barrier;          // posted by ARMCIX_Ibarrier
 #ifdef USE_RMA_REQUESTS
     int batch_size;
-    MPI_Request single_request; // used when batch_size=0 (common case)
-    MPI_Request *request_array; // used when batch_size>0
+    int request_capacity;       // size of request_array
+    MPI_Request inline_requests[ARMCI_HDL_INLINE_REQUESTS]; // used when batch_size<=ARMCI_HDL_INLINE_REQUESTS (common case)
+    MPI_Request *request_array; // used when batch_size>ARMCI_HDL_INLINE_REQUESTS
 #else
-    int target;    /* we do not actually support individual completion */
-    int aggregate;
+    int npairs;                   // (window, target) pairs with operations pending on this handle
+    armci_hdl_pair_t single_pair; // used when npairs=1 (common case)
+    armci_hdl_pair_t *pair_array; // used when npairs>1
 #endif
 }
 armci_hdl_t;
@@ -65,12 +65,21 @@
 #  define likely(x_)   (x_)
 #endif
 
+/* Thread-local storage class, used for per-thread scratch state */
+#ifdef HAVE_THREAD_LOCAL
+#  define ARMCII_THREAD_LOCAL THREAD_LOCAL_KEYWORD
+#  define ARMCII_HAVE_THREAD_LOCAL 1
+#else
+#  define ARMCII_THREAD_LOCAL
+#  define ARMCII_HAVE_THREAD_LOCAL 0
+#endif
+
 
 /* Disable safety checks if the user asks for it */
 
 #ifdef NO_SEATBELTS
 #define NO_CHECK_OVERLAP /* Disable checks for overlapping IOV operations */
-//#define NO_USE_CTREE     /* Use the slower O(N) check instead of the conflict tree */
+//#define NO_USE_CTREE     /* Use the slower O(N^2) pairwise check instead of sort-and-sweep */
 #define NO_CHECK_BUFFERS /* Disable checking for shared origin buffers    */
 
 #else
@@ -87,9 +96,13 @@ enum ARMCII_Iov_methods_e { ARMCII_IOV_AUTO, ARMCII_IOV_CONSRV,
 
 enum ARMCII_Shr_buf_methods_e { ARMCII_SHR_BUF_COPY, ARMCII_SHR_BUF_NOGUARD };
 
+enum ARMCII_Simd_levels_e { ARMCII_SIMD_NONE, ARMCII_SIMD_SSE2, ARMCII_SIMD_AVX2, ARMCII_SIMD_AVX512,
+                            ARMCII_SIMD_NLEVELS };
+
 extern char ARMCII_Strided_methods_str[][10];
 extern char ARMCII_Iov_methods_str[][10];
 extern char ARMCII_Shr_buf_methods_str[][10];
+extern char ARMCII_Simd_levels_str[][10];
 
 typedef struct {
   int           init_count;             /* Number of times ARMCI_Init has been called                           */
@@ -97,6 +110,7 @@ typedef struct {
   int           iov_checks;             /* Disable IOV same allocation and overlapping checks                   */
   int           iov_batched_limit;      /* Max number of ops per epoch for BATCHED IOV method                   */
   int           iov_dtype_chunk;         /* Max blocks per datatype op for DIRECT IOV method (0 = unlimited)     */
+  int           iov_coalesce;           /* Merge IOV segments that are contiguous at both origin and target     */
   int           noncollective_groups;   /* Use noncollective group creation algorithm                           */
   int           cache_rank_translation; /* Enable caching of translation between absolute and group ranks       */
   int           verbose;                /* ARMCI should produce extra status output                             */
@@ -106,6 +120,9 @@ typedef struct {
   int           use_win_allocate;       /* Use win_allocate or win_create (or special memory...)                */
   int           msg_barrier_syncs;      /* Call MPI_Win_sync in armci_msg_barrier                               */
   int           explicit_nb_progress;   /* Poke the MPI progress engine at the end of nonblocking (NB) calls    */
+  int           dirty_tracking;         /* Only flush targets with incomplete operations in Fence and WaitAll   */
+  int           agg_limit;              /* Largest put/acc queued on an aggregate handle (0 = no aggregation)   */
+  int           agg_bufsize;            /* Staging buffer size for operations queued on an aggregate handle     */
   int           use_alloc_shm;          /* Pass alloc_shm info to win_allocate / alloc_mem                      */
   int           rma_atomicity;          /* Use Accumulate and Get_accumulate for Put and Get                    */
   int           end_to_end_flush;       /* All flush_local calls become flush                                   */
@@ -116,6 +133,7 @@ typedef struct {
   int           use_request_atomics;    /* Use request-based RMA for atomic operations                          */
   int           flush_request_atomics;  /* Force remote completion (Win_flush) after request-based atomics      */
   char          rma_ordering[20];       /* Set accumulate_ordering=<this> window info key                       */
+  int           rma_ordered_waw;        /* Window accumulates are ordered write-after-write                     */
 
   size_t        memory_limit;           /* upper bound on how much memory ARMCI can allocate                    */
 #ifdef HAVE_MEMKIND_H
@@ -126,6 +144,7 @@ typedef struct {
   enum ARMCII_Strided_methods_e strided_method; /* Strided transfer method              */
   enum ARMCII_Iov_methods_e     iov_method;     /* IOV transfer method                  */
   enum ARMCII_Shr_buf_methods_e shr_buf_method; /* Shared buffer management method      */
+  enum ARMCII_Simd_levels_e     simd_level;     /* Vector ISA used by scaling kernels   */
 } global_state_t;
 
 
@@ -152,6 +171,18 @@ int   ARMCII_Getenv_int(const char *varname, int default_value);
 long  ARMCII_Getenv_long(const char *varname, long default_value);
 void ARMCII_Getenv_char(char * output, const char *varname, const char *default_value, int length);
 
+/* Per-thread scratch arena */
+
+void *ARMCII_Arena_alloc(size_t size);
+void  ARMCII_Arena_free(void *ptr);
+void  ARMCII_Arena_finalize(void);
+unsigned long ARMCII_Arena_heap_count(void);
+
+/* Shared counters */
+struct armcix_counter_s;
+
+long ARMCII_Counter_nfetch(struct armcix_counter_s *ctr);
+
 /* Synchronization */
 
 void ARMCII_Sync_local(void);
@@ -170,6 +201,10 @@ void ARMCII_Msg_sel_max_op(void *data_in, void *data_inout, int *len, MPI_Dataty
 int  ARMCII_Translate_absolute_to_group(ARMCI_Group *group, int world_rank);
 void ARMCII_Group_init_from_comm(ARMCI_Group *group);
 
+/* Allocation with gmr_create flags */
+
+int  ARMCII_Malloc_group(void **base_ptrs, armci_size_t size, ARMCI_Group *group, int gmr_flags);
+
 
 /* I/O Vector data management and implementation */
 
@@ -194,6 +229,8 @@ typedef struct {
 void ARMCII_Acc_type_translate(int armci_datatype, MPI_Datatype *type, int *type_size);
 
 int  ARMCII_Iov_check_overlap(void **ptrs, int count, int size);
+int  ARMCII_Iov_check_overlap_vl(void **ptrs, int count, const int *sizes);
+int  ARMCII_Iov_check_overlap_always(void **ptrs, int count, int size, const int *sizes);
 int  ARMCII_Iov_check_same_allocation(void **ptrs, int count, int proc);
 
 void ARMCII_Strided_to_iov(armci_giov_t *iov,
@@ -206,11 +243,29 @@ void ARMCII_Strided_to_dtype(int stride_array[/*stride_levels*/], int count[/*st
 
 int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
     int datatype, int overlapping, int same_alloc, int proc, int blocking, armci_hdl_t * handle);
+int ARMCII_Iov_op_dispatch_vl(enum ARMCII_Op_e op, void **src, void **dst, int count, const int *sizes,
+    int datatype, int overlapping, int same_alloc, int proc, int blocking, armci_hdl_t * handle);
 
 int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
-    MPI_Datatype type, int proc, int consrv /* if 1, batched = safe */, int blocking, armci_hdl_t * handle);
+    int *blk_counts, MPI_Datatype type, int proc, int consrv /* if 1, batched = safe */, int blocking, armci_hdl_t * handle);
 int ARMCII_Iov_op_datatype(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
-    MPI_Datatype type, int proc, int blocking, armci_hdl_t * handle);
+    int *blk_counts, MPI_Datatype type, int proc, int blocking, armci_hdl_t * handle);
+int ARMCII_Iov_coalesce(void **loc, void **rem, int count, int size,
+                        void **loc_out, void **rem_out, int *len_out);
+
+/** Regular (one- or two-level strided) I/O vector access pattern
+  */
+typedef struct {
+  int      levels;        /* Number of stride levels (1 or 2)       */
+  int      inner;         /* Segments per row                        */
+  int      outer;         /* Number of rows                          */
+  MPI_Aint loc_stride[2]; /* Local segment and row strides in bytes  */
+  MPI_Aint rem_stride[2]; /* Remote segment and row strides in bytes */
+} armcii_iov_pattern_t;
+
+int ARMCII_Iov_find_pattern(void **loc, void **rem, int count, int size, armcii_iov_pattern_t *pat);
+int ARMCII_Iov_op_pattern(enum ARMCII_Op_e op, void *loc, void *rem, armcii_iov_pattern_t *pat,
+    int elem_count, MPI_Datatype type, int proc, int blocking, armci_hdl_t *handle);
 
 armcii_iov_iter_t *ARMCII_Strided_to_iov_iter(
                void *src_ptr, int src_stride_ar[/*stride_levels*/],
@@ -221,18 +276,52 @@ int  ARMCII_Iov_iter_has_next(armcii_iov_iter_t *it);
 int  ARMCII_Iov_iter_next(armcii_iov_iter_t *it, void **src, void **dst);
 
 
+/* Aggregate handles */
+
+typedef struct armcii_agg_s armcii_agg_t;
+struct gmr_s;
+
+int  ARMCII_Agg_put(armci_hdl_t *handle, struct gmr_s *mreg, void *src, void *dst, int bytes, int proc);
+int  ARMCII_Agg_acc(armci_hdl_t *handle, struct gmr_s *mreg, int datatype, void *scale,
+                    void *src, void *dst, int bytes, int proc);
+void *ARMCII_Agg_stage(armci_hdl_t *handle, int bytes, int align);
+void ARMCII_Agg_issue(armci_hdl_t *handle);
+void ARMCII_Agg_release(armci_hdl_t *handle);
+void ARMCII_Agg_finalize(void);
+
+int  ARMCII_Callback_poll(int blocking);
+void ARMCII_Callback_finalize(void);
+
+
 /* Shared to private buffer management routines */
 
 int  ARMCII_Buf_prepare_read_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size);
-void ARMCII_Buf_finish_read_vec(void **orig_bufs, void **new_bufs, int count, int size);
+void ARMCII_Buf_finish_read_vec(void **new_bufs, int count);
 int  ARMCII_Buf_prepare_acc_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size,
                             int datatype, void *scale);
-void ARMCII_Buf_finish_acc_vec(void **orig_bufs, void **new_bufs, int count, int size);
+void ARMCII_Buf_finish_acc_vec(void **new_bufs, int count);
 int  ARMCII_Buf_prepare_write_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size);
 void ARMCII_Buf_finish_write_vec(void **orig_bufs, void **new_bufs, int count, int size);
 
+int  ARMCII_Buf_prepare_read_vecl(void **orig_bufs, void ***new_bufs_ptr, int count, const int *sizes);
+int  ARMCII_Buf_prepare_acc_vecl(void **orig_bufs, void ***new_bufs_ptr, int count, const int *sizes,
+                                 int datatype, void *scale);
+int  ARMCII_Buf_prepare_write_vecl(void **orig_bufs, void ***new_bufs_ptr, int count, const int *sizes);
+void ARMCII_Buf_finish_write_vecl(void **orig_bufs, void **new_bufs, int count, const int *sizes);
+
 int  ARMCII_Buf_acc_is_scaled(int datatype, void *scale);
 void ARMCII_Buf_acc_scale(void *buf_in, void *buf_out, int size, int datatype, void *scale);
+void ARMCII_Buf_acc_scale_strided(void *src_ptr, int src_stride_ar[/*stride_levels*/],
+                                  int count[/*stride_levels+1*/], int stride_levels,
+                                  void *buf_out, int datatype, void *scale);
+
+/* Scaling kernels: scale nelem scalar components of buf_in into buf_out */
+
+typedef void (*ARMCII_Scale_fn_t)(const void *buf_in, void *buf_out, int nelem, const void *scale);
+
+enum ARMCII_Simd_levels_e ARMCII_Simd_detect(void);
+ARMCII_Scale_fn_t ARMCII_Scale_kernel(int datatype, int *type_size);
+ARMCII_Scale_fn_t ARMCII_Scale_kernel_level(int datatype, enum ARMCII_Simd_levels_e level, int *type_size);
 
 int ARMCII_Is_win_unified(MPI_Win win);
 void ARMCII_Sync(void);
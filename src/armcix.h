@@ -43,4 +43,131 @@ void ARMCIX_Unlock_hdl(armcix_mutex_hdl_t hdl, int mutex, int proc);
 
 void ARMCIX_Progress(void);
 
+/** Transposed strided transfers: The remote array is a permutation of the
+  * dimensions of the local array; local dimension i maps to remote dimension
+  * perm[i].
+  */
+
+int ARMCIX_PutS_transpose(void *src_ptr, int src_stride_ar[/*stride_levels*/],
+                          void *dst_ptr, int dst_stride_ar[/*stride_levels*/],
+                          int count[/*stride_levels+1*/], int stride_levels,
+                          int perm[/*stride_levels+1*/], int elem_size, int proc);
+int ARMCIX_GetS_transpose(void *src_ptr, int src_stride_ar[/*stride_levels*/],
+                          void *dst_ptr, int dst_stride_ar[/*stride_levels*/],
+                          int count[/*stride_levels+1*/], int stride_levels,
+                          int perm[/*stride_levels+1*/], int elem_size, int proc);
+
+/** Variable-length I/O vectors: Like armci_giov_t, but each segment has its
+  * own length, bytes_array[i].
+  */
+
+typedef struct {
+  void **src_ptr_array;
+  void **dst_ptr_array;
+  int   *bytes_array;
+  int    ptr_array_len;
+} armcix_giovl_t;
+
+int ARMCIX_PutVL(armcix_giovl_t *iov, int iov_len, int proc);
+int ARMCIX_GetVL(armcix_giovl_t *iov, int iov_len, int proc);
+int ARMCIX_AccVL(int datatype, void *scale, armcix_giovl_t *iov, int iov_len, int proc);
+
+int ARMCIX_NbPutVL(armcix_giovl_t *iov, int iov_len, int proc, armci_hdl_t *handle);
+int ARMCIX_NbGetVL(armcix_giovl_t *iov, int iov_len, int proc, armci_hdl_t *handle);
+int ARMCIX_NbAccVL(int datatype, void *scale, armcix_giovl_t *iov, int iov_len, int proc, armci_hdl_t *handle);
+
+/** Multi-target strided transfers: Each descriptor is a strided transfer to
+  * its own target process.  All transfers are issued before any is completed,
+  * so the latencies of the targets overlap.
+  */
+
+typedef struct {
+  void *src_ptr;
+  int  *src_stride_ar;
+  void *dst_ptr;
+  int  *dst_stride_ar;
+  int  *count;
+  int   stride_levels;
+  int   proc;
+} armcix_strided_desc_t;
+
+int ARMCIX_PutS_multi(armcix_strided_desc_t *desc, int ndesc);
+int ARMCIX_GetS_multi(armcix_strided_desc_t *desc, int ndesc);
+int ARMCIX_AccS_multi(int datatype, void *scale, armcix_strided_desc_t *desc, int ndesc);
+
+/** Completion of several nonblocking handles: Inactive handles are ignored.
+  * Each call gathers the MPI requests of all the handles, so whichever handle
+  * finishes first is completed.  Index and outcount are -1 when no handle is
+  * active.  ARMCIX_Testsome requires RMA requests (USE_RMA_REQUESTS); without
+  * them it returns an error and completes nothing.
+  */
+
+int ARMCIX_Waitany(int count, armci_hdl_t handles[], int *index);
+int ARMCIX_Waitsome(int count, armci_hdl_t handles[], int *outcount, int indices[]);
+int ARMCIX_Testsome(int count, armci_hdl_t handles[], int *outcount, int indices[]);
+
+/** Split-phase barrier: Completes outstanding one-sided operations and posts
+  * a barrier on the world group that completes under ARMCI_Wait/ARMCI_Test
+  * on the handle.
+  */
+
+int ARMCIX_Ibarrier(armci_hdl_t *handle);
+
+/** Completion callbacks: The callback registered on a handle is invoked from
+  * ARMCIX_Progress once the handle's operations complete, or from the progress
+  * thread if ARMCI was initialized with MPI_THREAD_MULTIPLE.  The handle must
+  * not be used until then.  Callbacks require RMA requests (USE_RMA_REQUESTS);
+  * without them ARMCIX_Callback_hdl returns an error.
+  */
+
+typedef void (*armcix_callback_fn_t)(armci_hdl_t *handle, void *arg);
+
+int ARMCIX_Callback_hdl(armci_hdl_t *handle, armcix_callback_fn_t fn, void *arg);
+
+/** Batched atomics: n read-modify-write operations (ARMCI_Rmw ops) to any
+  * targets, issued together and completed with one flush per target.
+  */
+
+int ARMCIX_Rmw_vec(int op, int n, void *ploc[], void *prem[], int values[], int procs[]);
+
+/** Nonblocking atomics: Like ARMCI_Rmw, but the original value is written to
+  * ploc when the handle completes.
+  */
+
+int ARMCIX_NbRmw(int op, void *ploc, void *prem, int value, int proc, armci_hdl_t *handle);
+
+/** Extended atomics: Fetch-and-op with more operations and datatypes
+  * (ARMCI_ACC_INT, LNG, FLT or DBL), and compare-and-swap.  Like ARMCI_Rmw,
+  * these are atomic with respect to other RMW operations.  Compare-and-swap
+  * takes ARMCI_ACC_INT or LNG; Open MPI 4's shared memory transport crashes on
+  * the 8-byte form.
+  */
+
+enum ARMCIX_Rmw_op_e { ARMCIX_RMW_SUM, ARMCIX_RMW_MIN, ARMCIX_RMW_MAX, ARMCIX_RMW_REPLACE,
+                       ARMCIX_RMW_BAND, ARMCIX_RMW_BOR, ARMCIX_RMW_BXOR };
+
+int ARMCIX_Rmw_fetch_op(int op, int datatype, void *ploc, void *prem, void *value, int proc);
+int ARMCIX_Rmw_cas(int datatype, void *ploc, void *prem, void *compare, void *swap, int proc);
+
+/** Shared counters: A NXTVAL-style counter, starting at zero, on the first
+  * process of a group.  Processes on the same node combine their requests:
+  * one fetches a batch of values with a single remote fetch-and-add and the
+  * others draw from it in shared memory.  Values are unique, but are only
+  * increasing per node.
+  */
+
+typedef struct armcix_counter_s * armcix_counter_t;
+
+armcix_counter_t ARMCIX_Counter_create(ARMCI_Group *group, long batch);
+int  ARMCIX_Counter_destroy(armcix_counter_t ctr);
+long ARMCIX_Counter_next(armcix_counter_t ctr);
+
+/** Chunked counters: Declaring the total number of values lets processes
+  * draw chunks of [lo, hi) by guided self-scheduling, shrinking as the
+  * counter approaches the total.
+  */
+
+int  ARMCIX_Counter_set_total(armcix_counter_t ctr, long total);
+long ARMCIX_Counter_next_chunk(armcix_counter_t ctr, long *lo, long *hi);
+
 #endif /* _ARMCIX_H_ */
@@ -13,43 +13,108 @@
 #include <debug.h>
 
 
-/** Prepare a set of buffers for use with a put operation.  The returned set of
-  * buffers is guaranteed to be in private space.  Copies will be made if needed,
-  * the result should be completed by finish.
+/** Size of segment i of a buffer list: sizes[i], or size when all segments
+  * have the same size (sizes == NULL).
+  */
+static inline int ARMCII_Buf_seg_size(int size, const int *sizes, int i) {
+  return (sizes != NULL) ? sizes[i] : size;
+}
+
+
+/** Move the buffers of a list that lie in shared (GMR) space into private
+  * space.  All moved buffers share a single staging allocation, whose base is
+  * stored in new_bufs[count] (NULL if nothing was moved).  The per-buffer
+  * lookup is skipped entirely when the span covered by the list doesn't touch
+  * any local shared region.
   *
   * @param[in]  orig_bufs Original set of buffers.
-  * @param[out] new_bufs  Pointer to the set of private buffers.
+  * @param[out] new_bufs  Array of count+1 slots for the private buffers.
   * @param[in]  count     Number of entries in the buffer list.
-  * @param[in]  size      The size of the buffers (all are of the same size).
+  * @param[in]  size      The size of the buffers, when all are the same size.
+  * @param[in]  sizes     The size of each buffer, or NULL.
+  * @param[in]  copy      Copy the contents of moved buffers.
   * @return               Number of buffers that were moved.
   */
-int ARMCII_Buf_prepare_read_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size) {
-  int num_moved = 0;
+static int ARMCII_Buf_stage_shared(void **orig_bufs, void **new_bufs, int count, int size,
+                                   const int *sizes, int copy) {
+  const int me = ARMCI_GROUP_WORLD.rank;
+  uint8_t  *lo, *hi, *staging;
+  gmr_t    *mreg = NULL;
+  MPI_Aint  total = 0, off = 0;
+  int       i, num_moved = 0;
 
-  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
-    void **new_bufs = malloc(count*sizeof(void*));
-    int i;
+  new_bufs[count] = NULL;
 
-    for (i = 0; i < count; i++)
+  for (i = 0; i < count; i++)
+    new_bufs[i] = orig_bufs[i];
+
+  if (count == 0)
+    return 0;
+
+  lo = hi = orig_bufs[0];
+
+  for (i = 0; i < count; i++) {
+    uint8_t *buf_lo = orig_bufs[i];
+    uint8_t *buf_hi = buf_lo + ARMCII_Buf_seg_size(size, sizes, i);
+
+    if (buf_lo < lo) lo = buf_lo;
+    if (buf_hi > hi) hi = buf_hi;
+  }
+
+  /* Common case: the buffers are all in private space */
+  if (gmr_lookup_span(lo, hi, me) == NULL)
+    return 0;
+
+  // Check if each buffer is within a shared region.  Consecutive buffers
+  // usually fall in the same region, so check the previous one first.
+  for (i = 0; i < count; i++) {
+    uint8_t *buf = orig_bufs[i];
+
+    if (   mreg == NULL
+        || buf <  (uint8_t*) mreg->slices[me].base
+        || buf >= (uint8_t*) mreg->slices[me].base + mreg->slices[me].size)
+      mreg = gmr_lookup(buf, me);
+
+    if (mreg != NULL) {
       new_bufs[i] = NULL;
+      total      += ARMCII_Buf_seg_size(size, sizes, i);
+      num_moved++;
+    }
+  }
 
-    for (i = 0; i < count; i++) {
-      // Check if the source buffer is within a shared region.  If so, copy it
-      // into a private buffer.
-      gmr_t *mreg = gmr_lookup(orig_bufs[i], ARMCI_GROUP_WORLD.rank);
+  if (num_moved == 0)
+    return 0;
 
-      if (mreg != NULL) {
-        MPI_Alloc_mem(size, MPI_INFO_NULL, &new_bufs[i]);
-        ARMCII_Assert(new_bufs[i] != NULL);
+  MPI_Alloc_mem(total > 0 ? total : 1, MPI_INFO_NULL, &staging);
+  ARMCII_Assert(staging != NULL);
+  new_bufs[count] = staging;
 
-        ARMCI_Copy(orig_bufs[i], new_bufs[i], size);
-        // gmr_get(mreg, orig_bufs[i], new_bufs[i], size, ARMCI_GROUP_WORLD.rank);
+  for (i = 0; i < count; i++) {
+    if (new_bufs[i] == NULL) {
+      const int seg_size = ARMCII_Buf_seg_size(size, sizes, i);
 
-        num_moved++;
-      } else {
-        new_bufs[i] = orig_bufs[i];
-      }
+      new_bufs[i] = staging + off;
+      off        += seg_size;
+
+      if (copy)
+        ARMCI_Copy(orig_bufs[i], new_bufs[i], seg_size);
     }
+  }
+
+  return num_moved;
+}
+
+
+static int ARMCII_Buf_prepare_read_core(void **orig_bufs, void ***new_bufs_ptr, int count, int size,
+                                        const int *sizes) {
+  int num_moved = 0;
+
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
+    void **new_bufs = malloc((count+1)*sizeof(void*));
+    ARMCII_Assert(new_bufs != NULL);
+
+    // Copy source buffers that are within a shared region into private space
+    num_moved = ARMCII_Buf_stage_shared(orig_bufs, new_bufs, count, size, sizes, 1);
 
     *new_bufs_ptr = new_bufs;
   }
@@ -61,52 +126,59 @@ int ARMCII_Buf_prepare_read_vec(void **orig_bufs, void ***new_bufs_ptr, int coun
 }
 
 
-/** Finish a set of prepared buffers.  Will perform communication and copies as
-  * needed to ensure results are in the original buffers.  Temporary space will be
-  * freed.
+/** Prepare a set of buffers for use with a put operation.  The returned set of
+  * buffers is guaranteed to be in private space.  Copies will be made if needed,
+  * the result should be completed by finish.
   *
   * @param[in]  orig_bufs Original set of buffers.
-  * @param[out] new_bufs  Set of private buffers.
+  * @param[out] new_bufs  Pointer to the set of private buffers.
   * @param[in]  count     Number of entries in the buffer list.
   * @param[in]  size      The size of the buffers (all are of the same size).
+  * @return               Number of buffers that were moved.
   */
-void ARMCII_Buf_finish_read_vec(void **orig_bufs, void **new_bufs, int count, int size) {
-  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
-    int i;
-
-    for (i = 0; i < count; i++) {
-      if (orig_bufs[i] != new_bufs[i]) {
-        MPI_Free_mem(new_bufs[i]);
-      }
-    }
-
-    free(new_bufs);
-  }
+int ARMCII_Buf_prepare_read_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size) {
+  return ARMCII_Buf_prepare_read_core(orig_bufs, new_bufs_ptr, count, size, NULL);
 }
 
 
-/** Prepare a set of buffers for use with an accumulate operation.  The
-  * returned set of buffers is guaranteed to be in private space and scaled.
-  * Copies will be made if needed, the result should be completed by finish.
+/** Prepare a set of buffers of varying sizes for use with a put operation.
   *
   * @param[in]  orig_bufs Original set of buffers.
   * @param[out] new_bufs  Pointer to the set of private buffers.
   * @param[in]  count     Number of entries in the buffer list.
-  * @param[in]  size      The size of the buffers (all are of the same size).
-  * @param[in]  datatype  The type of the buffer.
-  * @param[in]  scale     Scaling constant to apply to each buffer.
+  * @param[in]  sizes     The size of each buffer.
   * @return               Number of buffers that were moved.
   */
-int ARMCII_Buf_prepare_acc_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size,
-                            int datatype, void *scale) {
+int ARMCII_Buf_prepare_read_vecl(void **orig_bufs, void ***new_bufs_ptr, int count, const int *sizes) {
+  return ARMCII_Buf_prepare_read_core(orig_bufs, new_bufs_ptr, count, 0, sizes);
+}
+
+
+/** Finish a set of buffers prepared for reading.  The originals were not
+  * modified, so only the temporary space is freed.
+  *
+  * @param[in]  new_bufs  Set of private buffers.
+  * @param[in]  count     Number of entries in the buffer list.
+  */
+void ARMCII_Buf_finish_read_vec(void **new_bufs, int count) {
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
+    if (new_bufs[count] != NULL)
+      MPI_Free_mem(new_bufs[count]);
+
+    free(new_bufs);
+  }
+}
+
+
+static int ARMCII_Buf_prepare_acc_core(void **orig_bufs, void ***new_bufs_ptr, int count, int size,
+                                       const int *sizes, int datatype, void *scale) {
 
   void **new_bufs;
   int i, scaled, num_moved = 0;
 
-  /* Allocate count+1 pointer slots.  The extra slot [count] records the base of a
-   * single contiguous MPI_Alloc_mem region when the scaled origin segments are gathered
-   * into one allocation (NULL otherwise), so ARMCII_Buf_finish_acc_vec knows to free one
-   * region instead of count separate ones. */
+  /* Allocate count+1 pointer slots.  The extra slot [count] records the base of the
+   * single contiguous MPI_Alloc_mem region that holds the moved or scaled origin
+   * segments (NULL otherwise), so ARMCII_Buf_finish_acc_vec frees one region. */
   new_bufs = malloc((count+1)*sizeof(void*));
   ARMCII_Assert(new_bufs != NULL);
   new_bufs[count] = NULL;
@@ -119,36 +191,33 @@ int ARMCII_Buf_prepare_acc_vec(void **orig_bufs, void ***new_bufs_ptr, int count
      * overflows the 32-bit element displacements used by the DIRECT (indexed) IOV
      * datatype path (ARMCII_Iov_op_datatype); a single allocation keeps every segment
      * within one small, bounded span. */
-    char *contig;
-    MPI_Alloc_mem((MPI_Aint)count*size, MPI_INFO_NULL, &contig);
+    char    *contig;
+    MPI_Aint total = 0, off = 0;
+
+    for (i = 0; i < count; i++)
+      total += ARMCII_Buf_seg_size(size, sizes, i);
+
+    MPI_Alloc_mem(total, MPI_INFO_NULL, &contig);
     ARMCII_Assert(contig != NULL);
     new_bufs[count] = contig;
 
     for (i = 0; i < count; i++) {
-      new_bufs[i] = contig + (MPI_Aint)i*size;
-      ARMCII_Buf_acc_scale(orig_bufs[i], new_bufs[i], size, datatype, scale);
-    }
-  } else {
-    for (i = 0; i < count; i++) {
-      gmr_t *mreg = NULL;
-
-      // Check if the source buffer is within a shared region.
-      if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
-        mreg = gmr_lookup(orig_bufs[i], ARMCI_GROUP_WORLD.rank);
+      const int seg_size = ARMCII_Buf_seg_size(size, sizes, i);
 
-      new_bufs[i] = orig_bufs[i];
+      new_bufs[i] = contig + off;
+      ARMCII_Buf_acc_scale(orig_bufs[i], new_bufs[i], seg_size, datatype, scale);
+      off += seg_size;
+    }
 
-      if (mreg != NULL) {
-        // The buffer is shared; copy it into a private buffer
-        MPI_Alloc_mem(size, MPI_INFO_NULL, &new_bufs[i]);
-        ARMCII_Assert(new_bufs[i] != NULL);
+    num_moved = count;
 
-        ARMCI_Copy(orig_bufs[i], new_bufs[i], size);
-      }
+  } else if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
+    // Copy source buffers that are within a shared region into private space
+    num_moved = ARMCII_Buf_stage_shared(orig_bufs, new_bufs, count, size, sizes, 1);
 
-      if (new_bufs[i] == orig_bufs[i])
-        num_moved++;
-    }
+  } else {
+    for (i = 0; i < count; i++)
+      new_bufs[i] = orig_bufs[i];
   }
 
   *new_bufs_ptr = new_bufs;
@@ -157,33 +226,76 @@ int ARMCII_Buf_prepare_acc_vec(void **orig_bufs, void ***new_bufs_ptr, int count
 }
 
 
-/** Finish a set of prepared buffers.  Will perform communication and copies as
-  * needed to ensure results are in the original buffers.  Temporary space will be
-  * freed.
+/** Prepare a set of buffers for use with an accumulate operation.  The
+  * returned set of buffers is guaranteed to be in private space and scaled.
+  * Copies will be made if needed, the result should be completed by finish.
   *
   * @param[in]  orig_bufs Original set of buffers.
-  * @param[out] new_bufs  Set of private buffers.
+  * @param[out] new_bufs  Pointer to the set of private buffers.
   * @param[in]  count     Number of entries in the buffer list.
   * @param[in]  size      The size of the buffers (all are of the same size).
+  * @param[in]  datatype  The type of the buffer.
+  * @param[in]  scale     Scaling constant to apply to each buffer.
+  * @return               Number of buffers that were moved.
+  */
+int ARMCII_Buf_prepare_acc_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size,
+                            int datatype, void *scale) {
+  return ARMCII_Buf_prepare_acc_core(orig_bufs, new_bufs_ptr, count, size, NULL, datatype, scale);
+}
+
+
+/** Prepare a set of buffers of varying sizes for use with an accumulate
+  * operation.
+  *
+  * @param[in]  orig_bufs Original set of buffers.
+  * @param[out] new_bufs  Pointer to the set of private buffers.
+  * @param[in]  count     Number of entries in the buffer list.
+  * @param[in]  sizes     The size of each buffer.
+  * @param[in]  datatype  The type of the buffer.
+  * @param[in]  scale     Scaling constant to apply to each buffer.
+  * @return               Number of buffers that were moved.
   */
-void ARMCII_Buf_finish_acc_vec(void **orig_bufs, void **new_bufs, int count, int size) {
-  int i;
+int ARMCII_Buf_prepare_acc_vecl(void **orig_bufs, void ***new_bufs_ptr, int count, const int *sizes,
+                                int datatype, void *scale) {
+  return ARMCII_Buf_prepare_acc_core(orig_bufs, new_bufs_ptr, count, 0, sizes, datatype, scale);
+}
 
-  if (new_bufs[count] != NULL) {
-    /* Scaled segments were gathered into a single contiguous allocation. */
+
+/** Finish a set of buffers prepared for accumulate.  The originals were not
+  * modified, so only the temporary space is freed.
+  *
+  * @param[in]  new_bufs  Set of private buffers.
+  * @param[in]  count     Number of entries in the buffer list.
+  */
+void ARMCII_Buf_finish_acc_vec(void **new_bufs, int count) {
+  if (new_bufs[count] != NULL)
     MPI_Free_mem(new_bufs[count]);
-  } else {
-    for (i = 0; i < count; i++) {
-      if (orig_bufs[i] != new_bufs[i]) {
-        MPI_Free_mem(new_bufs[i]);
-      }
-    }
-  }
 
   free(new_bufs);
 }
 
 
+static int ARMCII_Buf_prepare_write_core(void **orig_bufs, void ***new_bufs_ptr, int count, int size,
+                                         const int *sizes) {
+  int num_moved = 0;
+
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
+    void **new_bufs = malloc((count+1)*sizeof(void*));
+    ARMCII_Assert(new_bufs != NULL);
+
+    // Destination buffers that are within a shared region get a temporary
+    // private buffer to hold the result.
+    num_moved = ARMCII_Buf_stage_shared(orig_bufs, new_bufs, count, size, sizes, 0);
+
+    *new_bufs_ptr = new_bufs;
+  } else {
+    *new_bufs_ptr = orig_bufs;
+  }
+  
+  return num_moved;
+}
+
+
 /** Prepare a set of buffers for use with a get operation.  The returned set of
   * buffers is guaranteed to be in private space.  Copies will be made if needed,
   * the result should be completed by finish.
@@ -195,35 +307,39 @@ void ARMCII_Buf_finish_acc_vec(void **orig_bufs, void **new_bufs, int count, int
   * @return               Number of buffers that were moved.
   */
 int ARMCII_Buf_prepare_write_vec(void **orig_bufs, void ***new_bufs_ptr, int count, int size) {
-  int num_moved = 0;
+  return ARMCII_Buf_prepare_write_core(orig_bufs, new_bufs_ptr, count, size, NULL);
+}
 
+
+/** Prepare a set of buffers of varying sizes for use with a get operation.
+  *
+  * @param[in]  orig_bufs Original set of buffers.
+  * @param[out] new_bufs  Pointer to the set of private buffers.
+  * @param[in]  count     Number of entries in the buffer list.
+  * @param[in]  sizes     The size of each buffer.
+  * @return               Number of buffers that were moved.
+  */
+int ARMCII_Buf_prepare_write_vecl(void **orig_bufs, void ***new_bufs_ptr, int count, const int *sizes) {
+  return ARMCII_Buf_prepare_write_core(orig_bufs, new_bufs_ptr, count, 0, sizes);
+}
+
+
+static void ARMCII_Buf_finish_write_core(void **orig_bufs, void **new_bufs, int count, int size,
+                                         const int *sizes) {
   if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
-    void **new_bufs = malloc(count*sizeof(void*));
     int i;
 
-    for (i = 0; i < count; i++)
-      new_bufs[i] = NULL;
-
     for (i = 0; i < count; i++) {
-      // Check if the destination buffer is within a shared region.  If not, create
-      // a temporary private buffer to hold the result.
-      gmr_t *mreg = gmr_lookup(orig_bufs[i], ARMCI_GROUP_WORLD.rank);
-
-      if (mreg != NULL) {
-        MPI_Alloc_mem(size, MPI_INFO_NULL, &new_bufs[i]);
-        ARMCII_Assert(new_bufs[i] != NULL);
-        num_moved++;
-      } else {
-        new_bufs[i] = orig_bufs[i];
+      if (orig_bufs[i] != new_bufs[i]) {
+        ARMCI_Copy(new_bufs[i], orig_bufs[i], ARMCII_Buf_seg_size(size, sizes, i));
       }
     }
 
-    *new_bufs_ptr = new_bufs;
-  } else {
-    *new_bufs_ptr = orig_bufs;
+    if (new_bufs[count] != NULL)
+      MPI_Free_mem(new_bufs[count]);
+
+    free(new_bufs);
   }
-  
-  return num_moved;
 }
 
 
@@ -237,23 +353,19 @@ int ARMCII_Buf_prepare_write_vec(void **orig_bufs, void ***new_bufs_ptr, int cou
   * @param[in]  size      The size of the buffers (all are of the same size).
   */
 void ARMCII_Buf_finish_write_vec(void **orig_bufs, void **new_bufs, int count, int size) {
-  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
-    int i;
-
-    for (i = 0; i < count; i++) {
-      if (orig_bufs[i] != new_bufs[i]) {
-        gmr_t *mreg = gmr_lookup(orig_bufs[i], ARMCI_GROUP_WORLD.rank);
-        ARMCII_Assert(mreg != NULL);
-
-        ARMCI_Copy(new_bufs[i], orig_bufs[i], size);
-        // gmr_put(mreg, new_bufs[i], orig_bufs[i], size, ARMCI_GROUP_WORLD.rank);
+  ARMCII_Buf_finish_write_core(orig_bufs, new_bufs, count, size, NULL);
+}
 
-        MPI_Free_mem(new_bufs[i]);
-      }
-    }
 
-    free(new_bufs);
-  }
+/** Finish a set of prepared buffers of varying sizes.
+  *
+  * @param[in]  orig_bufs Original set of buffers.
+  * @param[out] new_bufs  Set of private buffers.
+  * @param[in]  count     Number of entries in the buffer list.
+  * @param[in]  sizes     The size of each buffer.
+  */
+void ARMCII_Buf_finish_write_vecl(void **orig_bufs, void **new_bufs, int count, const int *sizes) {
+  ARMCII_Buf_finish_write_core(orig_bufs, new_bufs, count, 0, sizes);
 }
 
 #define ARMCII_IS_EQUAL(op,thresh,a,b) (op((a)-(b)) < thresh)
@@ -306,130 +418,77 @@ int ARMCII_Buf_acc_is_scaled(int datatype, void *scale) {
 }
 
 
-/** Prepare a set of buffers for use with an accumulate operation.  The
-  * returned set of buffers is guaranteed to be in private space and scaled.
-  * Copies will be made if needed, the result should be completed by finish.
+/** Scale a buffer for use with an accumulate operation.
   *
-  * @param[in]  buf       Original set of buffers.
-  * @param[in]  count     Number of entries in the buffer list.
-  * @param[in]  size      The size of the buffers (all are of the same size).
+  * @param[in]  buf_in    Input buffer.
+  * @param[out] buf_out   Output buffer, must not overlap buf_in.
+  * @param[in]  size      The size of the buffers in bytes.
   * @param[in]  datatype  The type of the buffer.
   * @param[in]  scale     Scaling constant to apply to each buffer.
-  * @return               Pointer to the new buffer or buf
   */
 void ARMCII_Buf_acc_scale(void *buf_in, void *buf_out, int size, int datatype, void *scale) {
-  int   j, nelem;
-  int   type_size = -1;
-
-  switch (datatype) {
-    case ARMCI_ACC_INT:
-      MPI_Type_size(MPI_INT, &type_size);
-      nelem= size/type_size;
+  int type_size;
+  ARMCII_Scale_fn_t kernel = ARMCII_Scale_kernel(datatype, &type_size);
 
-      {
-        int *src_i = (int*) buf_in;
-        int *scl_i = (int*) buf_out;
-        const int s = *((int*) scale);
-
-        for (j = 0; j < nelem; j++)
-          scl_i[j] = src_i[j]*s;
-      }
-      break;
+  ARMCII_Assert_msg(size % type_size == 0, 
+      "Transfer size is not a multiple of the datatype size");
 
-    case ARMCI_ACC_LNG:
-      MPI_Type_size(MPI_LONG, &type_size);
-      nelem= size/type_size;
+  kernel(buf_in, buf_out, size/type_size, scale);
+}
 
-      {
-        long *src_l = (long*) buf_in;
-        long *scl_l = (long*) buf_out;
-        const long s = *((long*) scale);
 
-        for (j = 0; j < nelem; j++)
-          scl_l[j] = src_l[j]*s;
-      }
-      break;
+/** Gather a strided buffer into a contiguous buffer and scale it in a single
+  * pass.  Rows of count[0] bytes are scaled directly out of the strided source,
+  * so no intermediate IO vector or copy is created.
+  *
+  * @param[in]  src_ptr        Starting address of the strided source.
+  * @param[in]  src_stride_ar  Source array of stride distances in bytes.
+  * @param[in]  count          Block size in each dimension. count[0] should be the
+  *                            number of bytes of contiguous data in leading dimension.
+  * @param[in]  stride_levels  The level of strides.
+  * @param[out] buf_out        Contiguous output buffer of size prod(count).
+  * @param[in]  datatype       The type of the buffer.
+  * @param[in]  scale          Scaling constant to apply to each element.
+  */
+void ARMCII_Buf_acc_scale_strided(void *src_ptr, int src_stride_ar[/*stride_levels*/],
+                                  int count[/*stride_levels+1*/], int stride_levels,
+                                  void *buf_out, int datatype, void *scale) {
+  int      idx[stride_levels+1];
+  int      i, type_size, nelem;
+  uint8_t *out = (uint8_t*) buf_out;
+  ARMCII_Scale_fn_t kernel = ARMCII_Scale_kernel(datatype, &type_size);
+
+  ARMCII_Assert_msg(count[0] % type_size == 0, 
+      "Transfer size is not a multiple of the datatype size");
 
-    case ARMCI_ACC_FLT:
-      MPI_Type_size(MPI_FLOAT, &type_size);
-      nelem= size/type_size;
+  nelem = count[0]/type_size;
 
-      {
-        float *src_f = (float*) buf_in;
-        float *scl_f = (float*) buf_out;
-        const float s = *((float*) scale);
+  for (i = 0; i < stride_levels+1; i++) {
+    if (count[i] == 0)
+      return;
+    idx[i] = 0;
+  }
 
-        for (j = 0; j < nelem; j++)
-          scl_f[j] = src_f[j]*s;
-      }
-      break;
+  while (stride_levels == 0 || idx[stride_levels-1] < count[stride_levels]) {
+    MPI_Aint disp = 0;
 
-    case ARMCI_ACC_DBL:
-      MPI_Type_size(MPI_DOUBLE, &type_size);
-      nelem= size/type_size;
+    for (i = 0; i < stride_levels; i++)
+      disp += (MPI_Aint) src_stride_ar[i]*idx[i];
 
-      {
-        double *src_d = (double*) buf_in;
-        double *scl_d = (double*) buf_out;
-        const double s = *((double*) scale);
+    kernel(((uint8_t*)src_ptr) + disp, out, nelem, scale);
+    out += count[0];
 
-        for (j = 0; j < nelem; j++)
-          scl_d[j] = src_d[j]*s;
-      }
+    if (stride_levels == 0)
       break;
 
-    case ARMCI_ACC_CPL:
-      MPI_Type_size(MPI_FLOAT, &type_size);
-      nelem= size/type_size;
-
-      {
-        float *src_fc = (float*) buf_in;
-        float *scl_fc = (float*) buf_out;
-        const float s_r = ((float*)scale)[0];
-        const float s_c = ((float*)scale)[1];
-
-        for (j = 0; j < nelem; j += 2) {
-          // Complex multiplication: (a + bi)*(c + di)
-          const float src_fc_j   = src_fc[j];
-          const float src_fc_j_1 = src_fc[j+1];
-          /*
-          scl_fc[j]   = src_fc[j]*s_r   - src_fc[j+1]*s_c;
-          scl_fc[j+1] = src_fc[j+1]*s_r + src_fc[j]*s_c;
-          */
-          scl_fc[j]   = src_fc_j*s_r   - src_fc_j_1*s_c;
-          scl_fc[j+1] = src_fc_j_1*s_r + src_fc_j*s_c;
-        }
-      }
-      break;
+    // Increment innermost index and propagate "carry" overflows outward
+    idx[0] += 1;
 
-    case ARMCI_ACC_DCP:
-      MPI_Type_size(MPI_DOUBLE, &type_size);
-      nelem= size/type_size;
-
-      {
-        double *src_dc = (double*) buf_in;
-        double *scl_dc = (double*) buf_out;
-        const double s_r = ((double*)scale)[0];
-        const double s_c = ((double*)scale)[1];
-
-        for (j = 0; j < nelem; j += 2) {
-          // Complex multiplication: (a + bi)*(c + di)
-          const double src_dc_j   = src_dc[j];
-          const double src_dc_j_1 = src_dc[j+1];
-          /*
-          scl_dc[j]   = src_dc[j]*s_r   - src_dc[j+1]*s_c;
-          scl_dc[j+1] = src_dc[j+1]*s_r + src_dc[j]*s_c;
-          */
-          scl_dc[j]   = src_dc_j*s_r   - src_dc_j_1*s_c;
-          scl_dc[j+1] = src_dc_j_1*s_r + src_dc_j*s_c;
-        }
+    for (i = 0; i < stride_levels-1; i++) {
+      if (idx[i] >= count[i+1]) {
+        idx[i]    = 0;
+        idx[i+1] += 1;
       }
-      break;
-
-    default:
-      ARMCII_Error("unknown data type (%d)", datatype);
+    }
   }
-
-  ARMCII_Assert_msg(size % type_size == 0, 
-      "Transfer size is not a multiple of the datatype size");
 }
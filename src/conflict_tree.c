@@ -12,6 +12,10 @@
   * is performed, it will fail.  Thus, objects in the tree are totally ordered
   * and a standard binary tree (in this case, the AVL tree) is sufficient for
   * detecting conflicts.
+  *
+  * IOV operations check a whole vector at once with a sort-and-sweep (see
+  * vector.c); the tree is meant for incremental use.  Nodes come from a
+  * per-thread pool of slabs rather than individual mallocs.
   */
 
 #include <stdio.h>
@@ -31,6 +35,96 @@ static inline void ctree_rotate_right(ctree_t node);
 const ctree_t CTREE_EMPTY = NULL;
 
 
+/* Node pool: Slabs of nodes are carved into a free list, linked through the
+ * parent pointer.  Without thread-local storage the pool is only used when
+ * ARMCI is not multithreaded. */
+
+#define CTREE_SLAB_NODES 256
+
+typedef struct ctree_slab_s {
+  struct ctree_slab_s *next;
+  struct ctree_node_s  nodes[CTREE_SLAB_NODES];
+} ctree_slab_t;
+
+static ARMCII_THREAD_LOCAL ctree_t       ctree_free_nodes = NULL;
+static ARMCII_THREAD_LOCAL ctree_slab_t *ctree_slabs      = NULL;
+static ARMCII_THREAD_LOCAL int           ctree_live_nodes = 0;
+
+
+static inline int ctree_pool_usable(void) {
+#if ARMCII_HAVE_THREAD_LOCAL
+  return 1;
+#else
+  return ARMCII_GLOBAL_STATE.thread_level != MPI_THREAD_MULTIPLE;
+#endif
+}
+
+
+/** Allocate a tree node from the calling thread's pool.
+  */
+static ctree_t ctree_node_alloc(void) {
+  ctree_t node;
+
+  if (!ctree_pool_usable()) {
+    node = malloc(sizeof(struct ctree_node_s));
+    ARMCII_Assert(node != NULL);
+    return node;
+  }
+
+  if (ctree_free_nodes == NULL) {
+    ctree_slab_t *slab = malloc(sizeof(ctree_slab_t));
+    int i;
+
+    ARMCII_Assert(slab != NULL);
+
+    slab->next  = ctree_slabs;
+    ctree_slabs = slab;
+
+    for (i = 0; i < CTREE_SLAB_NODES; i++) {
+      slab->nodes[i].parent = ctree_free_nodes;
+      ctree_free_nodes      = &slab->nodes[i];
+    }
+  }
+
+  node             = ctree_free_nodes;
+  ctree_free_nodes = node->parent;
+  ctree_live_nodes++;
+
+  return node;
+}
+
+
+/** Return a tree node to the calling thread's pool.
+  */
+static void ctree_node_free(ctree_t node) {
+  if (!ctree_pool_usable()) {
+    free(node);
+    return;
+  }
+
+  node->parent     = ctree_free_nodes;
+  ctree_free_nodes = node;
+  ctree_live_nodes--;
+}
+
+
+/** Release the calling thread's node pool.  Does nothing while any tree
+  * built by this thread is still live.
+  */
+void ctree_pool_finalize(void) {
+  if (ctree_live_nodes != 0)
+    return;
+
+  while (ctree_slabs != NULL) {
+    ctree_slab_t *next = ctree_slabs->next;
+    free(ctree_slabs);
+    ctree_slabs = next;
+  }
+
+  ctree_free_nodes = NULL;
+}
+
+
 /** Locate the node that conflicts with the given address range.
   *
   * @param[in] root Root of the ctree.
@@ -68,7 +162,7 @@ ctree_t ctree_locate(ctree_t root, uint8_t *lo, uint8_t *hi) {
   */
 int ctree_insert(ctree_t *root, uint8_t *lo, uint8_t *hi) {
   ctree_t cur;
-  ctree_t new_node = (ctree_t) malloc(sizeof(struct ctree_node_s));
+  ctree_t new_node = ctree_node_alloc();
 
   new_node->lo     = lo;
   new_node->hi     = hi;
@@ -92,7 +186,7 @@ int ctree_insert(ctree_t *root, uint8_t *lo, uint8_t *hi) {
         || (hi >= cur->lo && hi <= cur->hi)
         || (lo <  cur->lo && hi >  cur->hi)) {
       ARMCII_Dbg_print(DEBUG_CAT_CTREE, "Conflict inserting [%p, %p] with [%p, %p]\n", lo, hi, cur->lo, cur->hi);
-      free(new_node);
+      ctree_node_free(new_node);
       return 1;
     }
 
@@ -278,7 +372,7 @@ static void ctree_destroy_rec(ctree_t root) {
   ctree_destroy_rec(root->left);
   ctree_destroy_rec(root->right);
 
-  free(root);
+  ctree_node_free(root);
 }
 
 
@@ -26,6 +26,7 @@ int     ctree_insert(ctree_t *root, uint8_t *lo, uint8_t *hi);
 ctree_t ctree_locate(ctree_t root, uint8_t *lo, uint8_t *hi);
 void    ctree_destroy(ctree_t *root);
 void    ctree_print(ctree_t root);
+void    ctree_pool_finalize(void);
 
 
 #endif /* _CONFLICT_TREE_H */
@@ -0,0 +1,312 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <mpi.h>
+
+#include <armci.h>
+#include <armci_internals.h>
+#include <armcix.h>
+#include <debug.h>
+#include <gmr.h>
+
+#if defined(HAVE_STDATOMIC_H) && !defined(__STDC_NO_ATOMICS__)
+#  include <stdatomic.h>
+#  if ATOMIC_LLONG_LOCK_FREE == 2
+#    define ARMCII_COUNTER_COMBINING
+#  endif
+#endif
+
+#ifdef ARMCII_COUNTER_COMBINING
+
+/* Node-combining: The node state lives in a shared memory window on the
+ * node's first process.  State packs the generation of the current batch in
+ * the high 32 bits and the offset of the next draw in the low 32 bits, so a
+ * draw is one fetch-and-add.  The draw that lands just past the end of the
+ * batch refills it; later ones wait for the generation to change.  Bases are
+ * double buffered by generation parity, and a base isn't replaced until every
+ * draw of the previous generation that uses it has read it. */
+
+#define ARMCII_COUNTER_GEN_SHIFT 32
+#define ARMCII_COUNTER_OFF_MASK  0xffffffffULL
+
+typedef struct {
+  atomic_ullong state;     /* Generation and next offset of the current batch  */
+  atomic_llong  base[2];   /* First value of the batch, by generation parity   */
+  atomic_llong  nread[2];  /* Draws from that batch that have read its base    */
+} armcii_counter_node_t;
+
+#endif /* ARMCII_COUNTER_COMBINING */
+
+struct armcix_counter_s {
+  ARMCI_Group  grp;        /* Duplicate of the creating group                  */
+  void       **bases;      /* Counter allocation, only nonempty on the root    */
+  gmr_t       *mreg;       /* Memory region of the counter allocation          */
+  int          root;       /* Absolute id of the process holding the counter   */
+  int          nproc;      /* Number of processes in the group                 */
+  long         batch;      /* Values fetched by each remote operation          */
+  long         total;      /* Declared number of values, or 0 if unknown       */
+  long         estimate;   /* Counter value seen by this process's last chunk  */
+  long         nfetch;     /* Remote fetch-and-adds issued by this process     */
+#ifdef ARMCII_COUNTER_COMBINING
+  MPI_Comm     node_comm;  /* Processes in the group that share memory         */
+  MPI_Win      node_win;   /* Shared window holding the node state             */
+  armcii_counter_node_t *node; /* Node state, or NULL when not combining       */
+#endif
+};
+
+
+/** Fetch-and-add on the remote counter.
+  */
+static long ARMCII_Counter_fetch(armcix_counter_t ctr, long count) {
+  long value;
+
+  gmr_fetch_and_op(ctr->mreg, &count, &value, ctr->bases[0], MPI_LONG, MPI_SUM, ctr->root);
+  ctr->nfetch++;
+
+  return value;
+}
+
+
+/** Number of remote fetch-and-adds that this process has issued on a
+  * counter, which node combining and chunking keep below the number of
+  * values drawn.
+  */
+long ARMCII_Counter_nfetch(armcix_counter_t ctr) {
+  return ctr->nfetch;
+}
+
+
+/** Create a shared counter.  Collective on the ARMCI group.
+  *
+  * @param[in] group ARMCI group on which to create the counter
+  * @param[in] batch Values fetched for the node at a time, or <= 0 for the
+  *                  number of processes on the node
+  * @return          Handle to the counter
+  */
+armcix_counter_t ARMCIX_Counter_create(ARMCI_Group *group, long batch) {
+  armcix_counter_t ctr;
+  int rank, nproc;
+
+  ctr = malloc(sizeof(struct armcix_counter_s));
+  ARMCII_Assert(ctr != NULL);
+
+  ARMCIX_Group_dup(group, &ctr->grp);
+
+  MPI_Comm_rank(ctr->grp.comm, &rank);
+  MPI_Comm_size(ctr->grp.comm, &nproc);
+
+  ctr->root  = ARMCI_Absolute_id(&ctr->grp, 0);
+  ctr->bases = malloc(nproc*sizeof(void*));
+  ARMCII_Assert(ctr->bases != NULL);
+
+  ARMCI_Malloc_group(ctr->bases, (rank == 0) ? sizeof(long) : 0, &ctr->grp);
+
+  if (rank == 0) {
+    PARMCI_Access_begin(ctr->bases[0]);
+    *(long*) ctr->bases[0] = 0;
+    PARMCI_Access_end(ctr->bases[0]);
+  }
+
+  ctr->mreg     = gmr_lookup(ctr->bases[0], ctr->root);
+  ctr->nproc    = nproc;
+  ctr->batch    = 1;
+  ctr->total    = 0;
+  ctr->estimate = 0;
+  ctr->nfetch   = 0;
+  ARMCII_Assert(ctr->mreg != NULL);
+
+#ifdef ARMCII_COUNTER_COMBINING
+  {
+    int node_rank, node_size;
+
+    MPI_Comm_split_type(ctr->grp.comm, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &ctr->node_comm);
+    MPI_Comm_rank(ctr->node_comm, &node_rank);
+    MPI_Comm_size(ctr->node_comm, &node_size);
+
+    if (node_size > 1) {
+      MPI_Aint size;
+      int      disp_unit;
+
+      ctr->batch = (batch > 0) ? batch : node_size;
+      ARMCII_Assert_msg(ctr->batch < INT_MAX - node_size, "Counter batch is too large");
+
+      MPI_Win_allocate_shared((node_rank == 0) ? sizeof(armcii_counter_node_t) : 0, 1,
+                              MPI_INFO_NULL, ctr->node_comm, &ctr->node, &ctr->node_win);
+      MPI_Win_shared_query(ctr->node_win, 0, &size, &disp_unit, &ctr->node);
+      MPI_Win_lock_all(MPI_MODE_NOCHECK, ctr->node_win);
+
+      /* The first draw finds generation 0 exhausted and refills */
+      if (node_rank == 0) {
+        atomic_init(&ctr->node->state, (unsigned long long) ctr->batch);
+        atomic_init(&ctr->node->base[0], 0);
+        atomic_init(&ctr->node->base[1], 0);
+        atomic_init(&ctr->node->nread[0], ctr->batch);
+        atomic_init(&ctr->node->nread[1], ctr->batch);
+        MPI_Win_sync(ctr->node_win);
+      }
+    } else {
+      MPI_Comm_free(&ctr->node_comm);
+      ctr->node_win = MPI_WIN_NULL;
+      ctr->node     = NULL;
+    }
+  }
+#endif
+
+  /* Nobody draws before the counter and the node state are initialized */
+  MPI_Barrier(ctr->grp.comm);
+
+#ifdef ARMCII_COUNTER_COMBINING
+  if (ctr->node != NULL)
+    MPI_Win_sync(ctr->node_win);
+#endif
+
+  return ctr;
+}
+
+
+/** Destroy a shared counter.  Collective.
+  *
+  * @param[in] ctr Counter to destroy
+  * @return        Zero on success, non-zero otherwise
+  */
+int ARMCIX_Counter_destroy(armcix_counter_t ctr) {
+  int rank;
+
+  MPI_Comm_rank(ctr->grp.comm, &rank);
+
+#ifdef ARMCII_COUNTER_COMBINING
+  if (ctr->node != NULL) {
+    MPI_Win_unlock_all(ctr->node_win);
+    MPI_Win_free(&ctr->node_win);
+    MPI_Comm_free(&ctr->node_comm);
+  }
+#endif
+
+  ARMCI_Free_group(ctr->bases[rank], &ctr->grp);
+  ARMCI_Group_free(&ctr->grp);
+
+  free(ctr->bases);
+  free(ctr);
+
+  return 0;
+}
+
+
+#ifdef ARMCII_COUNTER_COMBINING
+
+/** Draw a value from the node's batch, refilling it when it runs out.
+  */
+static long ARMCII_Counter_draw(armcix_counter_t ctr) {
+  armcii_counter_node_t *node = ctr->node;
+  const unsigned long long batch = ctr->batch;
+
+  for (;;) {
+    unsigned long long state = atomic_fetch_add(&node->state, 1);
+    unsigned long long gen   = state >> ARMCII_COUNTER_GEN_SHIFT;
+    unsigned long long off   = state & ARMCII_COUNTER_OFF_MASK;
+
+    if (off < batch) {
+      long value = (long) (atomic_load(&node->base[gen & 1]) + off);
+
+      atomic_fetch_add(&node->nread[gen & 1], 1);
+      return value;
+    }
+    else if (off == batch) {
+      const int slot = (gen + 1) & 1;
+      long value;
+
+      /* Draws from the previous generation may not have read this base yet */
+      while (atomic_load(&node->nread[slot]) < (long long) batch)
+        ;
+
+      value = ARMCII_Counter_fetch(ctr, ctr->batch);
+
+      /* Offset 0 of the new batch is ours */
+      atomic_store(&node->nread[slot], 1);
+      atomic_store(&node->base[slot], value);
+      atomic_store(&node->state, ((gen + 1) << ARMCII_COUNTER_GEN_SHIFT) | 1);
+
+      return value;
+    }
+    else {
+      /* Another process is refilling; the root may be among the waiters, so
+       * keep MPI progressing */
+      while ((atomic_load(&node->state) >> ARMCII_COUNTER_GEN_SHIFT) == gen)
+        gmr_progress();
+    }
+  }
+}
+
+#endif /* ARMCII_COUNTER_COMBINING */
+
+
+/** Draw the next value from a shared counter.  Each value is returned to
+  * exactly one caller.
+  *
+  * @param[in] ctr Counter
+  * @return        Counter value
+  */
+long ARMCIX_Counter_next(armcix_counter_t ctr) {
+#ifdef ARMCII_COUNTER_COMBINING
+  if (ctr->node != NULL)
+    return ARMCII_Counter_draw(ctr);
+#endif
+
+  return ARMCII_Counter_fetch(ctr, 1);
+}
+
+
+/** Declare the number of values that will be drawn from a shared counter,
+  * which sets the chunk sizes of ARMCIX_Counter_next_chunk.  Local.
+  *
+  * @param[in] ctr   Counter
+  * @param[in] total Number of values, or 0 if unknown
+  * @return          Zero on success, non-zero otherwise
+  */
+int ARMCIX_Counter_set_total(armcix_counter_t ctr, long total) {
+  ARMCII_Assert(total >= 0);
+  ctr->total = total;
+
+  return 0;
+}
+
+
+/** Draw a chunk of consecutive values from a shared counter, by guided
+  * self-scheduling: each chunk is a share of the values that remain below the
+  * declared total, so chunks are large early and shrink to one value near the
+  * end.  The remaining count comes from this process's last chunk, so it
+  * lags the counter and chunks err on the large side; the last one is cut
+  * at the total.  Without a declared total, chunks are single values.  This fetches
+  * directly from the counter and doesn't use node combining.
+  *
+  * @param[in]  ctr Counter
+  * @param[out] lo  First value of the chunk
+  * @param[out] hi  One past the last value of the chunk
+  * @return         Number of values in the chunk, zero once the total is
+  *                 exhausted
+  */
+long ARMCIX_Counter_next_chunk(armcix_counter_t ctr, long *lo, long *hi) {
+  long chunk = 1;
+
+  if (ctr->total > 0 && ctr->estimate < ctr->total) {
+    /* Split what's left between twice the number of processes, since the
+     * others are drawing too */
+    const long share = 2L * ctr->nproc;
+
+    chunk = (ctr->total - ctr->estimate + share - 1) / share;
+  }
+
+  *lo = ARMCII_Counter_fetch(ctr, chunk);
+  *hi = *lo + chunk;
+
+  ctr->estimate = *hi;
+
+  if (ctr->total > 0 && *hi > ctr->total)
+    *hi = (*lo < ctr->total) ? ctr->total : *lo;
+
+  return *hi - *lo;
+}
@@ -8,6 +8,13 @@
 #include <debug.h>
 #include <gmr.h>
 
+#if defined(HAVE_STDATOMIC_H) && !defined(__STDC_NO_ATOMICS__)
+#  include <stdatomic.h>
+#  if (ATOMIC_INT_LOCK_FREE == 2) && (ATOMIC_LONG_LOCK_FREE == 2) && (ATOMIC_LLONG_LOCK_FREE == 2)
+#    define GMR_HAVE_SHM_ATOMICS
+#  endif
+#endif
+
 /** Linked list of shared memory regions.
   */
 gmr_t *gmr_list = NULL;
@@ -16,6 +23,78 @@ gmr_t *gmr_list = NULL;
 static pthread_mutex_t gmr_list_mutex = PTHREAD_MUTEX_INITIALIZER;
 #endif
 
+/** List of memory regions with targets that have incomplete operations, and
+  * the number of regions that use the separate memory model.
+  */
+static gmr_t *gmr_dirty_list = NULL;
+static int    gmr_nseparate  = 0;
+
+
+/** Record that operations were issued to a target of a memory region, so that
+  * Fence and WaitProc/WaitAll only need to flush the targets that were used.
+  *
+  * @param[in] mreg     Memory region
+  * @param[in] grp_proc Target rank in the memory region's group
+  * @param[in] flags    GMR_DIRTY_* flags describing the operation
+  */
+static inline void gmr_mark_dirty(gmr_t *mreg, int grp_proc, int flags)
+{
+  if (!ARMCII_GLOBAL_STATE.dirty_tracking)
+    return;
+
+  if (mreg->dirty_pos[grp_proc] == 0) {
+    mreg->dirty_targets[mreg->ndirty++] = grp_proc;
+    mreg->dirty_pos[grp_proc] = mreg->ndirty;
+
+    if (!mreg->dirty_listed) {
+      mreg->dirty_next   = gmr_dirty_list;
+      mreg->dirty_listed = true;
+      gmr_dirty_list     = mreg;
+    }
+  }
+
+  mreg->dirty_flags[grp_proc] |= flags;
+}
+
+
+/** Clear completion flags of a target after it was flushed.  The target leaves
+  * the dirty set once all of its flags are clear.
+  *
+  * @param[in] mreg     Memory region
+  * @param[in] grp_proc Target rank in the memory region's group
+  * @param[in] flags    GMR_DIRTY_* flags that the flush completed
+  */
+static inline void gmr_clean_target(gmr_t *mreg, int grp_proc, int flags)
+{
+  int pos = mreg->dirty_pos[grp_proc];
+
+  if (pos == 0)
+    return;
+
+  mreg->dirty_flags[grp_proc] &= ~flags;
+
+  if (mreg->dirty_flags[grp_proc] == 0) {
+    /* Move the last entry into the vacated slot */
+    int last = mreg->dirty_targets[--mreg->ndirty];
+
+    mreg->dirty_targets[pos-1] = last;
+    mreg->dirty_pos[last]      = pos;
+    mreg->dirty_pos[grp_proc]  = 0;
+  }
+}
+
+
+/** Flags completed by a flush.  A local flush is a remote one when end-to-end
+  * flushing is enabled.
+  */
+static inline int gmr_flush_completes(int local_only)
+{
+  if (!local_only || ARMCII_GLOBAL_STATE.end_to_end_flush)
+    return GMR_DIRTY_PENDING | GMR_DIRTY_WRITE;
+  else
+    return GMR_DIRTY_PENDING;
+}
+
 #ifdef USE_RMA_REQUESTS
 
 #if defined(OPEN_MPI) && defined(OMPI_MAJOR_VERSION) && (OMPI_MAJOR_VERSION >= 5)
@@ -67,9 +146,10 @@ static void gmr_request_rma_end(void)
   * @param[in]  local_size Size of the local slice of the memory region.
   * @param[out] base_ptrs  Array of base pointers for each process in group.
   * @param[in]  group      Group on which to perform allocation.
+  * @param[in]  flags      GMR_* flags, which must match on all processes.
   * @return                Pointer to the memory region object.
   */
-gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
+gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group, int flags) {
   int           i;
   int           alloc_me, alloc_nproc;
   int           world_me, world_nproc;
@@ -119,6 +199,16 @@ gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
   mreg->prev           = NULL;
   mreg->next           = NULL;
   mreg->unified        = false;
+  mreg->ndirty         = 0;
+  mreg->dirty_listed   = false;
+  mreg->dirty_next     = NULL;
+  mreg->shm_window     = MPI_WIN_NULL;
+  mreg->shm_bases      = NULL;
+
+  mreg->dirty_targets  = malloc(sizeof(int)*alloc_nproc);
+  mreg->dirty_pos      = calloc(alloc_nproc, sizeof(int));
+  mreg->dirty_flags    = calloc(alloc_nproc, sizeof(unsigned char));
+  ARMCII_Assert(mreg->dirty_targets != NULL && mreg->dirty_pos != NULL && mreg->dirty_flags != NULL);
 
   /* Allocate my slice of the GMR */
   alloc_slices[alloc_me].size = local_size;
@@ -185,6 +275,54 @@ gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
   /* give hint to CASPER to avoid extra work for lock permission */
   MPI_Info_set(win_info, "epochs_used", "lockall");
 
+#ifdef GMR_HAVE_SHM_ATOMICS
+  if (flags & GMR_SHM_ATOMICS) {
+      /* Slices come from a shared window on each node, so node peers can
+       * apply atomics directly, and the RMA window is created over them.
+       * When the whole group is on one node, the shared window is the RMA
+       * window. */
+      MPI_Comm  shm_comm;
+      MPI_Group shm_group, world_group;
+      int       shm_nproc;
+
+      MPI_Comm_split_type(group->comm, MPI_COMM_TYPE_SHARED, alloc_me, MPI_INFO_NULL, &shm_comm);
+      MPI_Win_allocate_shared((MPI_Aint) local_size, 1, win_info, shm_comm,
+                              &(alloc_slices[alloc_me].base), &mreg->shm_window);
+
+      if (local_size == 0)
+        alloc_slices[alloc_me].base = NULL;
+
+      mreg->shm_bases = calloc(world_nproc, sizeof(void*));
+      ARMCII_Assert(mreg->shm_bases != NULL);
+
+      MPI_Comm_size(shm_comm, &shm_nproc);
+      MPI_Comm_group(shm_comm, &shm_group);
+      MPI_Comm_group(ARMCI_GROUP_WORLD.comm, &world_group);
+
+      for (i = 0; i < shm_nproc; i++) {
+        MPI_Aint size;
+        int      disp_unit, world_rank;
+        void    *base;
+
+        MPI_Win_shared_query(mreg->shm_window, i, &size, &disp_unit, &base);
+        MPI_Group_translate_ranks(shm_group, 1, &i, world_group, &world_rank);
+        mreg->shm_bases[world_rank] = (size > 0) ? base : NULL;
+      }
+
+      MPI_Group_free(&shm_group);
+      MPI_Group_free(&world_group);
+      MPI_Comm_free(&shm_comm);
+
+      if (shm_nproc == alloc_nproc) {
+        mreg->window     = mreg->shm_window;
+        mreg->shm_window = MPI_WIN_NULL;
+      } else {
+        MPI_Win_create(alloc_slices[alloc_me].base, (MPI_Aint) local_size, 1, win_info, group->comm, &mreg->window);
+        MPI_Win_lock_all(MPI_MODE_NOCHECK, mreg->shm_window);
+      }
+  }
+  else
+#endif
   if (ARMCII_GLOBAL_STATE.use_win_allocate == 0) {
 
       if (local_size == 0) {
@@ -320,6 +458,9 @@ gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group) {
   }
 #endif
 
+  if (!mreg->unified)
+    gmr_nseparate++;
+
   /* Append the new region onto the region list */
   if (gmr_list == NULL) {
     gmr_list = mreg;
@@ -401,6 +542,19 @@ void gmr_destroy(gmr_t *mreg, ARMCI_Group *group) {
   }
 #endif
 
+  /* Remove from the list of regions with incomplete operations */
+  if (mreg->dirty_listed) {
+    gmr_t **cur = &gmr_dirty_list;
+
+    while (*cur != mreg)
+      cur = &(*cur)->dirty_next;
+
+    *cur = mreg->dirty_next;
+  }
+
+  if (!mreg->unified)
+    gmr_nseparate--;
+
   /* Remove from the list of mem regions */
   if (mreg->prev == NULL) {
     ARMCII_Assert(gmr_list == mreg);
@@ -428,7 +582,14 @@ void gmr_destroy(gmr_t *mreg, ARMCI_Group *group) {
   /* Destroy the window and free all buffers */
   MPI_Win_free(&mreg->window);
 
-  if (ARMCII_GLOBAL_STATE.use_win_allocate == 0) {
+  if (mreg->shm_bases != NULL) {
+    if (mreg->shm_window != MPI_WIN_NULL) {
+      MPI_Win_unlock_all(mreg->shm_window);
+      MPI_Win_free(&mreg->shm_window);
+    }
+    free(mreg->shm_bases);
+  }
+  else if (ARMCII_GLOBAL_STATE.use_win_allocate == 0) {
     if (mreg->slices[world_me].base != NULL) {
       MPI_Free_mem(mreg->slices[world_me].base);
     }
@@ -443,6 +604,9 @@ void gmr_destroy(gmr_t *mreg, ARMCI_Group *group) {
 #endif
 
   free(mreg->slices);
+  free(mreg->dirty_targets);
+  free(mreg->dirty_pos);
+  free(mreg->dirty_flags);
   free(mreg);
 }
 
@@ -492,6 +656,29 @@ gmr_t *gmr_lookup(void *ptr, int proc) {
 }
 
 
+/** Find a shared memory region that intersects an address range.
+  *
+  * @param[in] lo   Lowest address of the range.
+  * @param[in] hi   One past the highest address of the range.
+  * @param[in] proc Process on which the range lives.
+  * @return         Pointer to a mem region object that intersects [lo, hi), or
+  *                 NULL if the range is entirely private.
+  */
+gmr_t *gmr_lookup_span(void *lo, void *hi, int proc) {
+  gmr_t *mreg;
+
+  for (mreg = gmr_list; mreg != NULL; mreg = mreg->next) {
+    const uint8_t   *base = mreg->slices[proc].base;
+    const gmr_size_t size = mreg->slices[proc].size;
+
+    if (size > 0 && (uint8_t*) lo < base + size && (uint8_t*) hi > base)
+      break;
+  }
+
+  return mreg;
+}
+
+
 /** One-sided put operation.  Source buffer must be private.
   *
   * @param[in] mreg   Memory region
@@ -545,6 +732,8 @@ int gmr_put_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
   ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
   ARMCII_Assert_msg(disp + dst_count*extent <= mreg->slices[proc].size, "Transfer is out of range");
 
+  gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_PENDING | GMR_DIRTY_WRITE);
+
 #ifdef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
@@ -585,8 +774,8 @@ int gmr_put_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
 #ifndef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
-      /* Regular (not aggregate) handles merely store the target for future flushing. */
-      handle->target = grp_proc;
+      /* Without requests, the handle records what Wait has to flush. */
+      gmr_handle_add_target(handle, mreg, grp_proc);
   }
 
 #endif
@@ -648,6 +837,8 @@ int gmr_get_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
   ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
   ARMCII_Assert_msg(disp + src_count*extent <= mreg->slices[proc].size, "Transfer is out of range");
 
+  gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_PENDING);
+
 #ifdef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
@@ -689,8 +880,8 @@ int gmr_get_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src_type,
 #ifndef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
-      /* Regular (not aggregate) handles merely store the target for future flushing. */
-      handle->target = grp_proc;
+      /* Without requests, the handle records what Wait has to flush. */
+      gmr_handle_add_target(handle, mreg, grp_proc);
   }
 
 #endif
@@ -754,6 +945,8 @@ int gmr_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src
   ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
   ARMCII_Assert_msg(disp + dst_count*extent <= mreg->slices[proc].size, "Transfer is out of range");
 
+  gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_PENDING | GMR_DIRTY_WRITE);
+
 #ifdef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
@@ -781,8 +974,8 @@ int gmr_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype src
 #ifndef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
-      /* Regular (not aggregate) handles merely store the target for future flushing. */
-      handle->target = grp_proc;
+      /* Without requests, the handle records what Wait has to flush. */
+      gmr_handle_add_target(handle, mreg, grp_proc);
   }
 
 #endif
@@ -851,6 +1044,8 @@ int gmr_get_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype
   ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
   ARMCII_Assert_msg(disp + dst_count*extent <= mreg->slices[proc].size, "Transfer is out of range");
 
+  gmr_mark_dirty(mreg, grp_proc, (op == MPI_NO_OP) ? GMR_DIRTY_PENDING : GMR_DIRTY_PENDING | GMR_DIRTY_WRITE);
+
 #ifdef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
@@ -882,8 +1077,8 @@ int gmr_get_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype
 #ifndef USE_RMA_REQUESTS
 
   if (handle!=NULL) {
-      /* Regular (not aggregate) handles merely store the target for future flushing. */
-      handle->target = grp_proc;
+      /* Without requests, the handle records what Wait has to flush. */
+      gmr_handle_add_target(handle, mreg, grp_proc);
   }
 
 #endif
@@ -891,6 +1086,143 @@ int gmr_get_accumulate_typed(gmr_t *mreg, void *src, int src_count, MPI_Datatype
   return 0;
 }
 
+#ifdef GMR_HAVE_SHM_ATOMICS
+
+/* Integer fetch-and-op on an atomic object: every MPI_Op that ARMCI uses maps
+ * onto one C11 operation, except min and max, which need a CAS loop. */
+#define GMR_SHM_INT_FETCH_AND_OP(ctype, atype)                                  \
+  do {                                                                          \
+    atype      *obj = ptr;                                                      \
+    const ctype val = *(ctype*) src;                                            \
+    ctype       old, new;                                                       \
+                                                                                \
+    if      (op == MPI_SUM)     old = atomic_fetch_add(obj, val);               \
+    else if (op == MPI_REPLACE) old = atomic_exchange(obj, val);                \
+    else if (op == MPI_BAND)    old = atomic_fetch_and(obj, val);               \
+    else if (op == MPI_BOR)     old = atomic_fetch_or(obj, val);                \
+    else if (op == MPI_BXOR)    old = atomic_fetch_xor(obj, val);               \
+    else if (op == MPI_NO_OP)   old = atomic_load(obj);                         \
+    else if (op == MPI_MIN || op == MPI_MAX) {                                  \
+      old = atomic_load(obj);                                                   \
+      do {                                                                      \
+        new = (op == MPI_MIN) ? ((val < old) ? val : old)                       \
+                              : ((val > old) ? val : old);                      \
+      } while (new != old && !atomic_compare_exchange_weak(obj, &old, new));    \
+    }                                                                           \
+    else return 0;                                                              \
+                                                                                \
+    *(ctype*) out = old;                                                        \
+  } while (0)
+
+/* Floating point fetch-and-op: a CAS loop on the bits of the value */
+#define GMR_SHM_FLT_FETCH_AND_OP(ctype, utype, atype)                           \
+  do {                                                                          \
+    atype      *obj  = ptr;                                                     \
+    const ctype val  = *(ctype*) src;                                           \
+    utype       bits = atomic_load(obj), new_bits;                              \
+    ctype       old, new;                                                       \
+                                                                                \
+    for (;;) {                                                                  \
+      memcpy(&old, &bits, sizeof(ctype));                                       \
+                                                                                \
+      if      (op == MPI_SUM)     new = old + val;                              \
+      else if (op == MPI_REPLACE) new = val;                                    \
+      else if (op == MPI_MIN)     new = (val < old) ? val : old;                \
+      else if (op == MPI_MAX)     new = (val > old) ? val : old;                \
+      else if (op == MPI_NO_OP)   break;                                        \
+      else return 0;                                                            \
+                                                                                \
+      memcpy(&new_bits, &new, sizeof(ctype));                                   \
+      if (atomic_compare_exchange_weak(obj, &bits, new_bits))                   \
+        break;                                                                  \
+    }                                                                           \
+                                                                                \
+    *(ctype*) out = old;                                                        \
+  } while (0)
+
+/** Address of a destination element in this process's mapping of the node's
+  * shared memory, or NULL if the memory region doesn't use shared memory
+  * atomics or the target is on another node.
+  */
+static inline void *gmr_shm_address(gmr_t *mreg, void *dst, int proc)
+{
+  if (mreg->shm_bases == NULL || mreg->shm_bases[proc] == NULL)
+    return NULL;
+
+  return (uint8_t*) mreg->shm_bases[proc] + ((uint8_t*) dst - (uint8_t*) mreg->slices[proc].base);
+}
+
+/** Fetch-and-op with C11 atomics through shared memory, for regions created
+  * with GMR_SHM_ATOMICS and targets on this node.
+  *
+  * @return 1 if the operation was performed, 0 if the caller must use MPI
+  */
+static int gmr_shm_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
+                                MPI_Datatype type, MPI_Op op, int proc)
+{
+  void *ptr = gmr_shm_address(mreg, dst, proc);
+
+  if (ptr == NULL)
+    return 0;
+
+  if (type == MPI_INT)
+    GMR_SHM_INT_FETCH_AND_OP(int, atomic_int);
+  else if (type == MPI_LONG)
+    GMR_SHM_INT_FETCH_AND_OP(long, atomic_long);
+  else if (type == MPI_FLOAT && sizeof(float) == sizeof(unsigned int))
+    GMR_SHM_FLT_FETCH_AND_OP(float, unsigned int, atomic_uint);
+  else if (type == MPI_DOUBLE && sizeof(double) == sizeof(unsigned long long))
+    GMR_SHM_FLT_FETCH_AND_OP(double, unsigned long long, atomic_ullong);
+  else
+    return 0;
+
+  return 1;
+}
+
+/** Compare-and-swap with C11 atomics through shared memory.
+  *
+  * @return 1 if the operation was performed, 0 if the caller must use MPI
+  */
+static int gmr_shm_compare_and_swap(gmr_t *mreg, void *src, void *compare, void *out, void *dst,
+                                    MPI_Datatype type, int proc)
+{
+  void *ptr = gmr_shm_address(mreg, dst, proc);
+
+  if (ptr == NULL)
+    return 0;
+
+  /* On failure, expected is updated to the current value */
+  if (type == MPI_INT) {
+    int expected = *(int*) compare;
+    atomic_compare_exchange_strong((atomic_int*) ptr, &expected, *(int*) src);
+    *(int*) out = expected;
+  } else if (type == MPI_LONG) {
+    long expected = *(long*) compare;
+    atomic_compare_exchange_strong((atomic_long*) ptr, &expected, *(long*) src);
+    *(long*) out = expected;
+  } else {
+    return 0;
+  }
+
+  return 1;
+}
+
+#else
+
+static inline int gmr_shm_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
+                                       MPI_Datatype type, MPI_Op op, int proc)
+{
+  return 0;
+}
+
+static inline int gmr_shm_compare_and_swap(gmr_t *mreg, void *src, void *compare, void *out,
+                                           void *dst, MPI_Datatype type, int proc)
+{
+  return 0;
+}
+
+#endif /* GMR_HAVE_SHM_ATOMICS */
+
 /** One-sided fetch-and-op.  Source and output buffer must be private.
   *
   * @param[in] mreg      Memory region
@@ -919,6 +1251,9 @@ int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
   ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
   ARMCII_Assert_msg(disp <= mreg->slices[proc].size, "Transfer is out of range");
 
+  if (gmr_shm_fetch_and_op(mreg, src, out, dst, type, op, proc))
+    return 0;
+
   if (ARMCII_GLOBAL_STATE.use_request_atomics) {
 
     MPI_Request req;
@@ -929,6 +1264,8 @@ int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
      * so it should remain in the code indefinitely. */
     if (op == MPI_REPLACE || ARMCII_GLOBAL_STATE.flush_request_atomics) {
       MPI_Win_flush(grp_proc, mreg->window);
+    } else if (op != MPI_NO_OP) {
+      gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_WRITE);
     }
 
   } else {
@@ -938,6 +1275,8 @@ int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
       MPI_Win_flush(grp_proc, mreg->window);
     } else {
       MPI_Win_flush_local(grp_proc, mreg->window);
+      if (op != MPI_NO_OP)
+        gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_WRITE);
     }
 
   }
@@ -945,6 +1284,224 @@ int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst,
   return 0;
 }
 
+
+/** One-sided compare-and-swap.  Source, compare and output buffer must be
+  * private.
+  *
+  * @param[in] mreg      Memory region
+  * @param[in] src       Value to store if the destination equals compare
+  * @param[in] compare   Value to compare the destination with
+  * @param[in] out       Address of output buffer (same process as the source)
+  * @param[in] dst       Address of destination buffer
+  * @param[in] type      MPI datatype of the elements (integer types only)
+  * @param[in] proc      Absolute process id of target process
+  * @return              0 on success, non-zero on failure
+  */
+int gmr_compare_and_swap(gmr_t *mreg, void *src, void *compare, void *out, void *dst,
+                         MPI_Datatype type, int proc)
+{
+  int        grp_proc;
+  gmr_size_t disp;
+
+  grp_proc = ARMCII_Translate_absolute_to_group(&mreg->group, proc);
+  ARMCII_Assert(grp_proc >= 0);
+  ARMCII_Assert_msg(mreg->window != MPI_WIN_NULL, "A non-null mreg contains a null window.");
+
+  disp = (gmr_size_t) ((uint8_t*)dst - (uint8_t*)mreg->slices[proc].base);
+
+  ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
+
+  if (gmr_shm_compare_and_swap(mreg, src, compare, out, dst, type, proc))
+    return 0;
+
+  /* There is no request-based compare-and-swap, so ARMCI_USE_REQUEST_ATOMICS
+   * doesn't apply; complete it like MPI_Fetch_and_op */
+  MPI_Compare_and_swap(src, compare, out, type, grp_proc, (MPI_Aint) disp, mreg->window);
+
+  if (ARMCII_GLOBAL_STATE.end_to_end_flush) {
+    MPI_Win_flush(grp_proc, mreg->window);
+  } else {
+    MPI_Win_flush_local(grp_proc, mreg->window);
+    gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_WRITE);
+  }
+
+  return 0;
+}
+
+
+/** Nonblocking one-sided fetch-and-op, completed by the handle.  Source and
+  * output buffer must be private and must not be touched until the handle
+  * completes.
+  *
+  * @param[in] mreg      Memory region
+  * @param[in] src       Address of source data
+  * @param[in] out       Address of output buffer (same process as the source)
+  * @param[in] dst       Address of destination buffer
+  * @param[in] type      MPI datatype of the source, output and destination elements
+  * @param[in] op        MPI_Op to apply at the destination
+  * @param[in] proc      Absolute process id of target process
+  * @param[in] handle    Handle that completes the operation
+  * @return              0 on success, non-zero on failure
+  */
+int gmr_fetch_and_op_nb(gmr_t *mreg, void *src, void *out, void *dst,
+                        MPI_Datatype type, MPI_Op op, int proc, armci_hdl_t *handle)
+{
+  int        grp_proc;
+  gmr_size_t disp;
+
+  grp_proc = ARMCII_Translate_absolute_to_group(&mreg->group, proc);
+  ARMCII_Assert(grp_proc >= 0);
+  ARMCII_Assert_msg(mreg->window != MPI_WIN_NULL, "A non-null mreg contains a null window.");
+
+  disp = (gmr_size_t) ((uint8_t*)dst - (uint8_t*)mreg->slices[proc].base);
+
+  ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[proc].size, "Invalid remote address");
+
+  /* Shared memory atomics complete immediately, but the handle still has to
+   * show the operation so that Wait and Test find it active */
+  if (gmr_shm_fetch_and_op(mreg, src, out, dst, type, op, proc)) {
+#ifdef USE_RMA_REQUESTS
+    gmr_handle_add_request(handle, MPI_REQUEST_NULL);
+#else
+    gmr_handle_add_target(handle, mreg, grp_proc);
+#endif
+    return 0;
+  }
+
+#ifdef USE_RMA_REQUESTS
+
+  /* MPI has no request-based fetch-and-op */
+  return gmr_get_accumulate(mreg, src, out, dst, 1, type, op, proc, handle);
+
+#else
+
+  gmr_mark_dirty(mreg, grp_proc, (op == MPI_NO_OP) ? GMR_DIRTY_PENDING : GMR_DIRTY_PENDING | GMR_DIRTY_WRITE);
+
+  MPI_Fetch_and_op(src, out, type, grp_proc, (MPI_Aint) disp, op, mreg->window);
+
+  gmr_handle_add_target(handle, mreg, grp_proc);
+
+  return 0;
+
+#endif
+}
+
+
+typedef struct {
+  gmr_t *mreg;
+  int    grp_proc;
+} gmr_target_t;
+
+static int gmr_target_cmp(const void *a, const void *b) {
+  const gmr_target_t *x = a, *y = b;
+
+  if (x->mreg != y->mreg)
+    return ((uintptr_t) x->mreg < (uintptr_t) y->mreg) ? -1 : 1;
+
+  return (x->grp_proc > y->grp_proc) - (x->grp_proc < y->grp_proc);
+}
+
+/** Batch of one-sided fetch-and-ops.  All operations are issued before any
+  * is completed, and each (window, target) pair is then completed with a
+  * single flush, so the batch costs about one round trip.  Completion is the
+  * same as for gmr_fetch_and_op.  Source and output buffers must be private.
+  *
+  * @param[in] n         Number of operations
+  * @param[in] mregs     Memory region of each destination
+  * @param[in] src       Source data, n elements
+  * @param[in] out       Output buffer, n elements
+  * @param[in] dst       Address of each destination element
+  * @param[in] type      MPI datatype of the source, output and destination elements
+  * @param[in] op        MPI_Op to apply at the destinations
+  * @param[in] procs     Absolute process id of each target process
+  * @return              0 on success, non-zero on failure
+  */
+int gmr_fetch_and_op_vec(int n, gmr_t *mregs[], void *src, void *out, void *dst[],
+                         MPI_Datatype type, MPI_Op op, int procs[])
+{
+  const int    use_requests = ARMCII_GLOBAL_STATE.use_request_atomics;
+  gmr_target_t *targets;
+  MPI_Request  *reqs = NULL;
+  int          i, type_size;
+
+  if (n <= 0)
+    return 0;
+
+  MPI_Type_size(type, &type_size);
+
+  targets = ARMCII_Arena_alloc(n*sizeof(gmr_target_t));
+  if (use_requests)
+    reqs = ARMCII_Arena_alloc(n*sizeof(MPI_Request));
+
+  for (i = 0; i < n; i++) {
+    gmr_t     *mreg = mregs[i];
+    int        grp_proc;
+    gmr_size_t disp;
+
+    grp_proc = ARMCII_Translate_absolute_to_group(&mreg->group, procs[i]);
+    ARMCII_Assert(grp_proc >= 0);
+    ARMCII_Assert_msg(mreg->window != MPI_WIN_NULL, "A non-null mreg contains a null window.");
+
+    disp = (gmr_size_t) ((uint8_t*)dst[i] - (uint8_t*)mreg->slices[procs[i]].base);
+
+    ARMCII_Assert_msg(disp >= 0 && disp < mreg->slices[procs[i]].size, "Invalid remote address");
+
+    /* Shared memory atomics leave nothing to complete */
+    if (gmr_shm_fetch_and_op(mreg, (uint8_t*)src + i*type_size, (uint8_t*)out + i*type_size,
+                             dst[i], type, op, procs[i])) {
+      if (use_requests)
+        reqs[i] = MPI_REQUEST_NULL;
+      targets[i].mreg     = NULL;
+      targets[i].grp_proc = grp_proc;
+      continue;
+    }
+
+    if (use_requests)
+      MPI_Rget_accumulate((uint8_t*)src + i*type_size, 1, type, (uint8_t*)out + i*type_size, 1, type,
+                          grp_proc, (MPI_Aint) disp, 1, type, op, mreg->window, &reqs[i]);
+    else
+      MPI_Fetch_and_op((uint8_t*)src + i*type_size, (uint8_t*)out + i*type_size, type,
+                       grp_proc, (MPI_Aint) disp, op, mreg->window);
+
+    targets[i].mreg     = mreg;
+    targets[i].grp_proc = grp_proc;
+  }
+
+  if (use_requests)
+    MPI_Waitall(n, reqs, MPI_STATUSES_IGNORE);
+
+  /* Complete each distinct (window, target) pair once */
+  qsort(targets, n, sizeof(gmr_target_t), gmr_target_cmp);
+
+  for (i = 0; i < n; i++) {
+    gmr_t    *mreg     = targets[i].mreg;
+    const int grp_proc = targets[i].grp_proc;
+
+    if (mreg == NULL || (i > 0 && mreg == targets[i-1].mreg && grp_proc == targets[i-1].grp_proc))
+      continue;
+
+    if (use_requests) {
+      /* See gmr_fetch_and_op */
+      if (op == MPI_REPLACE || ARMCII_GLOBAL_STATE.flush_request_atomics)
+        MPI_Win_flush(grp_proc, mreg->window);
+      else if (op != MPI_NO_OP)
+        gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_WRITE);
+    } else if (ARMCII_GLOBAL_STATE.end_to_end_flush) {
+      MPI_Win_flush(grp_proc, mreg->window);
+    } else {
+      MPI_Win_flush_local(grp_proc, mreg->window);
+      if (op != MPI_NO_OP)
+        gmr_mark_dirty(mreg, grp_proc, GMR_DIRTY_WRITE);
+    }
+  }
+
+  if (use_requests)
+    ARMCII_Arena_free(reqs);
+  ARMCII_Arena_free(targets);
+
+  return 0;
+}
+
 /** Lock a memory region at all targets so that one-sided operations can be performed.
   *
   * @param[in] mreg     Memory region
@@ -999,6 +1556,8 @@ int gmr_flush(gmr_t *mreg, int proc, int local_only) {
     MPI_Win_flush_local(grp_proc, mreg->window);
   }
 
+  gmr_clean_target(mreg, grp_proc, gmr_flush_completes(local_only));
+
   return 0;
 }
 
@@ -1009,6 +1568,7 @@ int gmr_flush(gmr_t *mreg, int proc, int local_only) {
   */
 int gmr_flushall(gmr_t *mreg, int local_only) {
   int grp_me   = ARMCII_Translate_absolute_to_group(&mreg->group, ARMCI_GROUP_WORLD.rank);
+  int i;
 
   ARMCII_Assert(grp_me >= 0);
   ARMCII_Assert_msg(mreg->window != MPI_WIN_NULL, "A non-null mreg contains a null window.");
@@ -1019,6 +1579,10 @@ int gmr_flushall(gmr_t *mreg, int local_only) {
     MPI_Win_flush_local_all(mreg->window);
   }
 
+  /* Walk backwards so that removals don't skip entries */
+  for (i = mreg->ndirty-1; i >= 0; i--)
+    gmr_clean_target(mreg, mreg->dirty_targets[i], gmr_flush_completes(local_only));
+
   return 0;
 }
 
@@ -1043,6 +1607,131 @@ int gmr_sync(gmr_t *mreg)
   return 0;
 }
 
+/** Complete operations to one process on all memory regions.  With dirty
+  * tracking, only regions where that process has incomplete operations are
+  * flushed; otherwise every region is.
+  *
+  * @param[in] proc       Absolute process id of the target
+  * @param[in] local_only Only wait for local completion (WaitProc), rather than
+  *                       remote completion of writes (Fence)
+  * @return               0 on success, non-zero on failure
+  */
+int gmr_flush_dirty(int proc, int local_only) {
+  const int need = local_only ? GMR_DIRTY_PENDING : GMR_DIRTY_WRITE;
+  gmr_t **cur;
+
+  if (!ARMCII_GLOBAL_STATE.dirty_tracking) {
+    gmr_t *mreg;
+
+    for (mreg = gmr_list; mreg != NULL; mreg = mreg->next)
+      gmr_flush(mreg, proc, local_only);
+
+    return 0;
+  }
+
+  cur = &gmr_dirty_list;
+
+  while (*cur != NULL) {
+    gmr_t *mreg = *cur;
+    int grp_proc = ARMCII_Translate_absolute_to_group(&mreg->group, proc);
+
+    if (grp_proc >= 0 && (mreg->dirty_flags[grp_proc] & need))
+      gmr_flush(mreg, proc, local_only);
+
+    /* Drop regions that became clean from the list */
+    if (mreg->ndirty == 0) {
+      *cur = mreg->dirty_next;
+      mreg->dirty_listed = false;
+    } else {
+      cur = &mreg->dirty_next;
+    }
+  }
+
+  return 0;
+}
+
+
+/** Complete operations to all processes on all memory regions.  With dirty
+  * tracking, only the targets with incomplete operations are flushed; a
+  * region where most targets are dirty is flushed with a single flush_all.
+  *
+  * @param[in] local_only Only wait for local completion (WaitAll), rather than
+  *                       remote completion of writes (AllFence)
+  * @return               0 on success, non-zero on failure
+  */
+int gmr_flushall_dirty(int local_only) {
+  const int need = local_only ? GMR_DIRTY_PENDING : GMR_DIRTY_WRITE;
+  gmr_t **cur;
+
+  if (!ARMCII_GLOBAL_STATE.dirty_tracking) {
+    gmr_t *mreg;
+
+    for (mreg = gmr_list; mreg != NULL; mreg = mreg->next)
+      gmr_flushall(mreg, local_only);
+
+    return 0;
+  }
+
+  cur = &gmr_dirty_list;
+
+  while (*cur != NULL) {
+    gmr_t *mreg = *cur;
+    int i, nneed = 0;
+
+    for (i = 0; i < mreg->ndirty; i++)
+      if (mreg->dirty_flags[mreg->dirty_targets[i]] & need)
+        nneed++;
+
+    if (nneed > 0 && 2*nneed >= mreg->group.size) {
+      gmr_flushall(mreg, local_only);
+    }
+    else if (nneed > 0) {
+      /* Walk backwards so that removals don't skip entries */
+      for (i = mreg->ndirty-1; i >= 0; i--) {
+        int grp_proc = mreg->dirty_targets[i];
+
+        if (!(mreg->dirty_flags[grp_proc] & need))
+          continue;
+
+        if (!local_only || ARMCII_GLOBAL_STATE.end_to_end_flush)
+          MPI_Win_flush(grp_proc, mreg->window);
+        else
+          MPI_Win_flush_local(grp_proc, mreg->window);
+
+        gmr_clean_target(mreg, grp_proc, gmr_flush_completes(local_only));
+      }
+    }
+
+    /* Drop regions that became clean from the list */
+    if (mreg->ndirty == 0) {
+      *cur = mreg->dirty_next;
+      mreg->dirty_listed = false;
+    } else {
+      cur = &mreg->dirty_next;
+    }
+  }
+
+  return 0;
+}
+
+
+/** Sync all memory regions so that public and private windows are the same.
+  * Nothing needs to be done when all windows use the unified memory model.
+  *
+  * @return 0 on success, non-zero on failure
+  */
+int gmr_sync_all(void) {
+  gmr_t *mreg;
+
+  if (gmr_nseparate == 0)
+    return 0;
+
+  for (mreg = gmr_list; mreg != NULL; mreg = mreg->next)
+    gmr_sync(mreg);
+
+  return 0;
+}
+
 void gmr_progress(void)
 {
     if (ARMCII_GLOBAL_STATE.explicit_nb_progress) {
@@ -1052,55 +1741,257 @@ void gmr_progress(void)
     return;
 }
 
+#ifdef USE_RMA_REQUESTS
+
+/* Request array cache: Arrays that outgrow a handle's inline requests have
+ * power-of-two capacities.  When a handle completes, its array is kept in a
+ * per-thread cache for its size class, so handles that repeatedly aggregate
+ * the same number of operations don't allocate in steady state. */
+
+#define GMR_REQ_CACHE_MIN     (2*ARMCI_HDL_INLINE_REQUESTS) /* Capacity of the smallest class */
+#define GMR_REQ_CACHE_CLASSES 16                            /* Largest cached capacity is MIN<<15 */
+#define GMR_REQ_CACHE_DEPTH   4                             /* Arrays kept per class */
+
+typedef struct {
+  MPI_Request *arrays[GMR_REQ_CACHE_CLASSES][GMR_REQ_CACHE_DEPTH];
+  int          count[GMR_REQ_CACHE_CLASSES];
+} gmr_req_cache_t;
+
+static ARMCII_THREAD_LOCAL gmr_req_cache_t gmr_req_cache;
+
+
+/** Is it safe to use the request cache from this thread?  Without thread-local
+  * storage the cache is shared by all threads.
+  */
+static inline int gmr_req_cache_usable(void)
+{
+#if ARMCII_HAVE_THREAD_LOCAL
+  return 1;
+#else
+  return ARMCII_GLOBAL_STATE.thread_level != MPI_THREAD_MULTIPLE;
+#endif
+}
+
+
+/** Size class of a request array capacity, or -1 if it isn't cached.
+  */
+static inline int gmr_req_cache_class(int capacity)
+{
+  int c = 0;
+
+  while ((GMR_REQ_CACHE_MIN << c) < capacity)
+    c++;
+
+  return (c < GMR_REQ_CACHE_CLASSES) ? c : -1;
+}
+
+
+/** Get a request array with the given (power-of-two) capacity.
+  */
+static MPI_Request *gmr_req_array_alloc(int capacity)
+{
+  int c = gmr_req_cache_class(capacity);
+  MPI_Request *array;
+
+  if (c >= 0 && gmr_req_cache_usable() && gmr_req_cache.count[c] > 0)
+    return gmr_req_cache.arrays[c][--gmr_req_cache.count[c]];
+
+  array = malloc(capacity * sizeof(MPI_Request));
+  ARMCII_Assert(array != NULL);
+
+  return array;
+}
+
+
+/** Return a request array to the cache, or free it if its class is full.
+  */
+static void gmr_req_array_free(MPI_Request *array, int capacity)
+{
+  int c = gmr_req_cache_class(capacity);
+
+  if (c >= 0 && gmr_req_cache_usable() && gmr_req_cache.count[c] < GMR_REQ_CACHE_DEPTH)
+    gmr_req_cache.arrays[c][gmr_req_cache.count[c]++] = array;
+  else
+    free(array);
+}
+
+
+/** Release the calling thread's cached request arrays.  Called by the thread
+  * that finalizes ARMCI; caches of other threads are reclaimed at process exit.
+  */
+void gmr_request_cache_finalize(void)
+{
+  int c;
+
+  for (c = 0; c < GMR_REQ_CACHE_CLASSES; c++) {
+    while (gmr_req_cache.count[c] > 0)
+      free(gmr_req_cache.arrays[c][--gmr_req_cache.count[c]]);
+  }
+}
+
+
+/** Get the requests of a handle.
+  *
+  * @param[in] handle Nonblocking handle
+  * @return           Array of batch_size requests
+  */
+MPI_Request *gmr_handle_requests(armci_hdl_t * handle)
+{
+  return (handle->batch_size <= ARMCI_HDL_INLINE_REQUESTS) ? handle->inline_requests : handle->request_array;
+}
+
+
+/** Reset a handle whose requests have all completed.
+  *
+  * @param[in] handle Nonblocking handle
+  */
+void gmr_handle_reset(armci_hdl_t * handle)
+{
+  if (handle->request_array != NULL)
+    gmr_req_array_free(handle->request_array, handle->request_capacity);
+
+  handle->batch_size       = 0;
+  handle->request_capacity = 0;
+  handle->request_array    = NULL;
+}
+
+
+/** Append a request to a handle.  The first ARMCI_HDL_INLINE_REQUESTS requests
+  * are stored in the handle; beyond that they move to an array whose capacity
+  * doubles as it fills.
+  *
+  * @param[in] handle Nonblocking handle
+  * @param[in] req    Request to add
+  */
 void gmr_handle_add_request(armci_hdl_t * handle, MPI_Request req)
 {
   if (handle->batch_size < 0) {
 
     ARMCII_Warning("gmr_handle_add_request passed a bogus (uninitialized) handle.\n");
 
-  } else if (handle->batch_size == 0) {
+  } else if (handle->batch_size < ARMCI_HDL_INLINE_REQUESTS) {
 
-    if (handle->single_request != MPI_REQUEST_NULL) {
-      ARMCII_Warning("gmr_handle_add_request: handle is corrupt (single_request_array is not MPI_REQUEST_NULL).\n");
-    }
     if (handle->request_array != NULL) {
-      //ARMCII_Warning("gmr_handle_add_request: handle is corrupt (request_array is not NULL).\n");
+      ARMCII_Warning("gmr_handle_add_request: handle is corrupt (request_array is not NULL).\n");
     }
 
-    handle->batch_size     = 1;
-    handle->single_request = req;
+    handle->inline_requests[handle->batch_size++] = req;
 
-  } else if (handle->batch_size == 1) {
+  } else if (handle->batch_size == ARMCI_HDL_INLINE_REQUESTS) {
 
-    if (handle->single_request == MPI_REQUEST_NULL) {
-      ARMCII_Warning("gmr_handle_add_request: handle is corrupt (single_request_array is MPI_REQUEST_NULL).\n");
-    }
-    if (handle->request_array != NULL) {
-      //ARMCII_Warning("gmr_handle_add_request: handle is corrupt (request_array is not NULL).\n");
+    // the inline requests are full, so move them to an array with room to grow
+    handle->request_capacity = GMR_REQ_CACHE_MIN;
+    handle->request_array    = gmr_req_array_alloc(handle->request_capacity);
+    memcpy(handle->request_array, handle->inline_requests, ARMCI_HDL_INLINE_REQUESTS * sizeof(MPI_Request));
+    handle->request_array[handle->batch_size++] = req;
+
+  } else {
+
+    if (handle->request_array == NULL) {
+      ARMCII_Warning("gmr_handle_add_request: handle is corrupt (request_array is NULL).\n");
     }
 
-    // there is a single request in the handle, so we allocate space for two,
-    // then copy from the single request to the array and append the new one.
-    // we nullify the single request to make sure it is not usable.
-    handle->batch_size++;
-    handle->request_array    = malloc( handle->batch_size * sizeof(MPI_Request) );
-    handle->request_array[0] = handle->single_request;
-    handle->request_array[1] = req;
-    handle->single_request   = MPI_REQUEST_NULL;
+    // grow the array geometrically and append the new one.
+    if (handle->batch_size == handle->request_capacity) {
+      MPI_Request *array = gmr_req_array_alloc(2*handle->request_capacity);
 
-  } else if (handle->batch_size > 1) {
+      memcpy(array, handle->request_array, handle->batch_size * sizeof(MPI_Request));
+      gmr_req_array_free(handle->request_array, handle->request_capacity);
 
-    if (handle->single_request != MPI_REQUEST_NULL) {
-      ARMCII_Warning("gmr_handle_add_request: handle is corrupt (single_request_array is not MPI_REQUEST_NULL).\n");
+      handle->request_array     = array;
+      handle->request_capacity *= 2;
     }
-    if (handle->request_array == NULL) {
-      ARMCII_Warning("gmr_handle_add_request: handle is corrupt (request_array is NULL).\n");
+
+    handle->request_array[handle->batch_size++] = req;
+
+  }
+}
+
+#else
+
+/** Record that an operation on a handle was issued to the given target of a
+  * memory region.  Each (window, target) pair is stored once.
+  *
+  * @param[in] handle   Nonblocking handle
+  * @param[in] mreg     Memory region
+  * @param[in] grp_proc Target rank in the memory region's group
+  */
+void gmr_handle_add_target(armci_hdl_t * handle, gmr_t *mreg, int grp_proc)
+{
+  armci_hdl_pair_t pair;
+  int i;
+
+  pair.win    = mreg->window;
+  pair.target = grp_proc;
+
+  if (handle->npairs < 0) {
+
+    ARMCII_Warning("gmr_handle_add_target passed a bogus (uninitialized) handle.\n");
+
+  } else if (handle->npairs == 0) {
+
+    handle->npairs      = 1;
+    handle->single_pair = pair;
+
+  } else if (handle->npairs == 1) {
+
+    if (handle->single_pair.win == pair.win && handle->single_pair.target == pair.target)
+      return;
+
+    handle->npairs++;
+    handle->pair_array    = malloc( handle->npairs * sizeof(armci_hdl_pair_t) );
+    ARMCII_Assert(handle->pair_array != NULL);
+    handle->pair_array[0] = handle->single_pair;
+    handle->pair_array[1] = pair;
+
+  } else {
+
+    // the most recent pair is the most likely match
+    for (i = handle->npairs-1; i >= 0; i--) {
+      if (handle->pair_array[i].win == pair.win && handle->pair_array[i].target == pair.target)
+        return;
     }
 
-    // grow the allocation and append the new one.
-    handle->batch_size++;
-    handle->request_array  = realloc( handle->request_array , handle->batch_size * sizeof(MPI_Request) );
-    handle->request_array[handle->batch_size-1] = req;
+    handle->npairs++;
+    handle->pair_array = realloc( handle->pair_array, handle->npairs * sizeof(armci_hdl_pair_t) );
+    ARMCII_Assert(handle->pair_array != NULL);
+    handle->pair_array[handle->npairs-1] = pair;
+
+  }
+}
+
 
+/** Complete the operations on a handle by flushing only the (window, target)
+  * pairs that it recorded, then reset the handle.
+  *
+  * MPI-3 has no nonblocking flush, so without RMA requests there is no way to
+  * ask whether a handle's operations are done without completing them.  In
+  * this build, ARMCI_Test blocks in here until the handle completes locally,
+  * like ARMCI_Wait, and ARMCIX_Testsome and ARMCIX_Callback_hdl are refused.
+  *
+  * @param[in] handle Nonblocking handle
+  * @return           0 on success, non-zero on failure
+  */
+int gmr_wait(armci_hdl_t * handle)
+{
+  armci_hdl_pair_t *pairs = (handle->npairs == 1) ? &handle->single_pair : handle->pair_array;
+  int i;
+
+  for (i = 0; i < handle->npairs; i++) {
+    /* local completion only, unlike Fence */
+    if (ARMCII_GLOBAL_STATE.end_to_end_flush)
+      MPI_Win_flush(pairs[i].target, pairs[i].win);
+    else
+      MPI_Win_flush_local(pairs[i].target, pairs[i].win);
   }
+
+  if (handle->npairs > 1)
+    free(handle->pair_array);
+
+  handle->npairs     = 0;
+  handle->pair_array = NULL;
+
+  return 0;
 }
+
+#endif /* USE_RMA_REQUESTS */
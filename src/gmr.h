@@ -35,17 +35,41 @@ typedef struct gmr_s {
   gmr_slice_t            *slices;         /* Array of GMR slices for this allocation                        */
   int                     nslices;
   bool                    unified;        /* separate/unified attribute of the window                       */
+
+  int                    *dirty_targets;  /* Group ranks with operations that may be incomplete             */
+  int                    *dirty_pos;      /* Index+1 of each group rank in dirty_targets, 0 if clean        */
+  unsigned char          *dirty_flags;    /* GMR_DIRTY_* flags of each group rank                           */
+  int                     ndirty;
+  bool                    dirty_listed;   /* Region is on the dirty region list                             */
+  struct gmr_s           *dirty_next;
+
+  MPI_Win                 shm_window;     /* Shared memory window under the RMA window, or MPI_WIN_NULL     */
+  void                  **shm_bases;      /* Local address of each on-node slice, by absolute rank, or NULL */
 } gmr_t;
 
+/* gmr_create flags */
+#define GMR_SHM_ATOMICS   0x1             /* Atomics on on-node targets use shared memory (node-only RMW)   */
+
+/* Per-target completion state tracked for Fence and WaitProc/WaitAll */
+#define GMR_DIRTY_PENDING 0x1             /* Operations may not be locally complete                         */
+#define GMR_DIRTY_WRITE   0x2             /* Writes may not be remotely complete                            */
+
 extern gmr_t *gmr_list;
 
-gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group);
+gmr_t *gmr_create(gmr_size_t local_size, void **base_ptrs, ARMCI_Group *group, int flags);
 void   gmr_destroy(gmr_t *mreg, ARMCI_Group *group);
 int    gmr_destroy_all(void);
 gmr_t *gmr_lookup(void *ptr, int proc);
+gmr_t *gmr_lookup_span(void *lo, void *hi, int proc);
 
 // blocking
 int gmr_fetch_and_op(gmr_t *mreg, void *src, void *out, void *dst, MPI_Datatype type, MPI_Op op, int proc);
+int gmr_compare_and_swap(gmr_t *mreg, void *src, void *compare, void *out, void *dst,
+                         MPI_Datatype type, int proc);
+int gmr_fetch_and_op_nb(gmr_t *mreg, void *src, void *out, void *dst, MPI_Datatype type, MPI_Op op,
+                        int proc, armci_hdl_t *handle);
+int gmr_fetch_and_op_vec(int n, gmr_t *mregs[], void *src, void *out, void *dst[],
+                         MPI_Datatype type, MPI_Op op, int procs[]);
 
 // nonblocking
 int gmr_get(gmr_t *mreg, void *src, void *dst, int size,
@@ -76,9 +100,20 @@ int gmr_unlockall(gmr_t *mreg);
 int gmr_flush(gmr_t *mreg, int proc, int local_only);
 int gmr_flushall(gmr_t *mreg, int local_only);
 int gmr_sync(gmr_t *mreg);
-int gmr_wait(armci_hdl_t * handle);
+
+int gmr_flush_dirty(int proc, int local_only);
+int gmr_flushall_dirty(int local_only);
+int gmr_sync_all(void);
 
 void gmr_progress(void);
+#ifdef USE_RMA_REQUESTS
 void gmr_handle_add_request(armci_hdl_t * handle, MPI_Request req);
+MPI_Request *gmr_handle_requests(armci_hdl_t * handle);
+void gmr_handle_reset(armci_hdl_t * handle);
+void gmr_request_cache_finalize(void);
+#else
+void gmr_handle_add_target(armci_hdl_t * handle, gmr_t *mreg, int grp_proc);
+int  gmr_wait(armci_hdl_t * handle);
+#endif
 
 #endif /* HAVE_GMR_H */
@@ -6,6 +6,7 @@
 #include <armci_internals.h>
 #include <debug.h>
 #include <gmr.h>
+#include <conflict_tree.h>
 
 #ifdef ENABLE_PROGRESS
 #ifdef HAVE_PTHREADS
@@ -49,7 +50,12 @@ static void * progress_function(void * arg)
 #endif
 
     while(*active) {
-        ARMCIX_Progress();
+        /* Callbacks issue RMA from this thread, which ARMCI only allows at
+         * MPI_THREAD_MULTIPLE.  Otherwise they wait for ARMCIX_Progress. */
+        if (ARMCII_GLOBAL_STATE.thread_level == MPI_THREAD_MULTIPLE)
+            ARMCIX_Progress();
+        else
+            gmr_progress();
 #if defined(HAVE_NANOSLEEP)
         if (naptime) nanosleep(&napstruct,NULL);
 #elif defined(HAVE_USLEEP)
@@ -355,6 +361,10 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
   }
 
 
+  /* Sort IOV segments by remote address and merge those that are contiguous
+   * at both the origin and the target before issuing them. */
+  ARMCII_GLOBAL_STATE.iov_coalesce = ARMCII_Getenv_bool("ARMCI_IOV_COALESCE", 1);
+
   char *var = ARMCII_Getenv("ARMCI_IOV_METHOD");
   if (var != NULL) {
     if (strcmp(var, "AUTO") == 0)
@@ -416,6 +426,40 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
     }
   }
 
+  /* Vector ISA for the accumulate scaling kernels: the best one the CPU
+   * supports, unless a lower level is requested. */
+  {
+    enum ARMCII_Simd_levels_e simd_max = ARMCII_Simd_detect();
+
+    ARMCII_GLOBAL_STATE.simd_level = simd_max;
+
+    var = ARMCII_Getenv("ARMCI_SIMD");
+    if (var != NULL) {
+      enum ARMCII_Simd_levels_e i;
+      int found = 0;
+
+      if (strcmp(var, "AUTO") == 0)
+        found = 1;
+
+      for (i = ARMCII_SIMD_NONE; i < ARMCII_SIMD_NLEVELS && !found; i++) {
+        if (strcmp(var, ARMCII_Simd_levels_str[i]) == 0) {
+          found = 1;
+
+          if (i > simd_max) {
+            if (ARMCI_GROUP_WORLD.rank == 0)
+              ARMCII_Warning("ARMCI_SIMD=%s is not supported by this CPU, using %s\n",
+                             var, ARMCII_Simd_levels_str[simd_max]);
+          } else {
+            ARMCII_GLOBAL_STATE.simd_level = i;
+          }
+        }
+      }
+
+      if (!found && ARMCI_GROUP_WORLD.rank == 0)
+        ARMCII_Warning("Ignoring unknown value for ARMCI_SIMD (%s)\n", var);
+    }
+  }
+
   /* Use win_allocate or not, to work around MPI-3 RMA implementation bugs. */
   ARMCII_GLOBAL_STATE.use_win_allocate = ARMCII_Getenv_bool("ARMCI_USE_WIN_ALLOCATE", 1);
 
@@ -433,6 +477,31 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
   /* Poke the MPI progress engine at the end of nonblocking (NB) calls */
   ARMCII_GLOBAL_STATE.explicit_nb_progress=ARMCII_Getenv_bool("ARMCI_EXPLICIT_NB_PROGRESS", 1);
 
+  /* Track the targets with incomplete operations so that Fence and WaitProc/
+   * WaitAll only flush those.  The tracking is not thread-safe. */
+  ARMCII_GLOBAL_STATE.dirty_tracking=ARMCII_Getenv_bool("ARMCI_DIRTY_TRACKING", 1);
+
+  if (ARMCII_GLOBAL_STATE.dirty_tracking && ARMCII_GLOBAL_STATE.thread_level == MPI_THREAD_MULTIPLE) {
+    ARMCII_GLOBAL_STATE.dirty_tracking = 0;
+  }
+
+  /* Queue small puts and accumulates on aggregate handles and issue them as
+   * I/O vector operations when the handle is completed */
+  ARMCII_GLOBAL_STATE.agg_bufsize=ARMCII_Getenv_int("ARMCI_AGGREGATE_BUFSIZE", 65536);
+  if (ARMCII_GLOBAL_STATE.agg_bufsize <= 0) {
+    ARMCII_Warning("Ignoring invalid value for ARMCI_AGGREGATE_BUFSIZE (%d)\n", ARMCII_GLOBAL_STATE.agg_bufsize);
+    ARMCII_GLOBAL_STATE.agg_bufsize = 65536;
+  }
+
+  ARMCII_GLOBAL_STATE.agg_limit=ARMCII_Getenv_int("ARMCI_AGGREGATE_LIMIT", 1024);
+  if (ARMCII_GLOBAL_STATE.agg_limit < 0) {
+    ARMCII_Warning("Ignoring invalid value for ARMCI_AGGREGATE_LIMIT (%d)\n", ARMCII_GLOBAL_STATE.agg_limit);
+    ARMCII_GLOBAL_STATE.agg_limit = 1024;
+  }
+  if (ARMCII_GLOBAL_STATE.agg_limit > ARMCII_GLOBAL_STATE.agg_bufsize) {
+    ARMCII_GLOBAL_STATE.agg_limit = ARMCII_GLOBAL_STATE.agg_bufsize;
+  }
+
   /* Pass alloc_shm=<this> to win_allocate / alloc_mem */
   ARMCII_GLOBAL_STATE.use_alloc_shm=ARMCII_Getenv_bool("ARMCI_USE_ALLOC_SHM", 1);
 
@@ -467,6 +536,10 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
   ARMCII_Getenv_char(ARMCII_GLOBAL_STATE.rma_ordering, "ARMCI_RMA_ORDERING", "rar,raw,war,waw",
                      sizeof(ARMCII_GLOBAL_STATE.rma_ordering)-1);
 
+  /* An empty string leaves the MPI default, which orders all accumulates */
+  ARMCII_GLOBAL_STATE.rma_ordered_waw = strlen(ARMCII_GLOBAL_STATE.rma_ordering) == 0
+                                     || strstr(ARMCII_GLOBAL_STATE.rma_ordering, "waw") != NULL;
+
   /* Flush_local becomes flush */
   ARMCII_GLOBAL_STATE.end_to_end_flush=ARMCII_Getenv_bool("ARMCI_NO_FLUSH_LOCAL", 0);
 
@@ -645,6 +718,8 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
           printf("  IOV_DTYPE_CHUNK        = UNLIMITED\n");
       }
 
+      printf("  IOV_COALESCE           = %s\n", ARMCII_GLOBAL_STATE.iov_coalesce           ? "TRUE" : "FALSE");
+
       /* MPI RMA semantics */
       printf("  RMA_ATOMICITY          = %s\n", ARMCII_GLOBAL_STATE.rma_atomicity          ? "TRUE" : "FALSE");
       printf("  NO_FLUSH_LOCAL         = %s\n", ARMCII_GLOBAL_STATE.end_to_end_flush       ? "TRUE" : "FALSE");
@@ -653,6 +728,9 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
       printf("  USE_REQUEST_ATOMICS    = %s\n", ARMCII_GLOBAL_STATE.use_request_atomics    ? "TRUE" : "FALSE");
       printf("  FLUSH_REQUEST_ATOMICS  = %s\n", ARMCII_GLOBAL_STATE.flush_request_atomics  ? "TRUE" : "FALSE");
       printf("  USE_RMA_REQUESTS       = %s\n", use_rma_requests ? "TRUE" : "FALSE"); // compile-time option
+      printf("  DIRTY_TRACKING         = %s\n", ARMCII_GLOBAL_STATE.dirty_tracking         ? "TRUE" : "FALSE");
+      printf("  AGGREGATE_LIMIT        = %d\n", ARMCII_GLOBAL_STATE.agg_limit);
+      printf("  AGGREGATE_BUFSIZE      = %d\n", ARMCII_GLOBAL_STATE.agg_bufsize);
 
       /* MPI info set on window */
       printf("  USE_ALLOC_SHM          = %s\n", ARMCII_GLOBAL_STATE.use_alloc_shm          ? "TRUE" : "FALSE");
@@ -664,6 +742,7 @@ int PARMCI_Init_thread_comm(int armci_requested, MPI_Comm comm) {
       /* ARMCI-MPI internal options */
       printf("  IOV_CHECKS             = %s\n", ARMCII_GLOBAL_STATE.iov_checks             ? "TRUE" : "FALSE");
       printf("  SHR_BUF_METHOD         = %s\n", ARMCII_Shr_buf_methods_str[ARMCII_GLOBAL_STATE.shr_buf_method]);
+      printf("  SIMD                   = %s\n", ARMCII_Simd_levels_str[ARMCII_GLOBAL_STATE.simd_level]);
       printf("  NONCOLLECTIVE_GROUPS   = %s\n", ARMCII_GLOBAL_STATE.noncollective_groups   ? "TRUE" : "FALSE");
       printf("  CACHE_RANK_TRANSLATION = %s\n", ARMCII_GLOBAL_STATE.cache_rank_translation ? "TRUE" : "FALSE");
       printf("  DEBUG_ALLOC            = %s\n", ARMCII_GLOBAL_STATE.debug_alloc            ? "TRUE" : "FALSE");
@@ -858,8 +937,18 @@ int PARMCI_Finalize(void) {
 #endif /* HAVE_PTHREADS */
 #endif /* ENABLE_PROGRESS */
 
+  /* Pending completion callbacks are invoked before the windows go away */
+  ARMCII_Callback_finalize();
+
   nfreed = gmr_destroy_all();
 
+  ARMCII_Arena_finalize();
+  ctree_pool_finalize();
+  ARMCII_Agg_finalize();
+#ifdef USE_RMA_REQUESTS
+  gmr_request_cache_finalize();
+#endif
+
   if (nfreed > 0 && ARMCI_GROUP_WORLD.rank == 0) {
     ARMCII_Warning("Freed %d leaked allocations\n", nfreed);
   }
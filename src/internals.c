@@ -19,6 +19,7 @@ global_state_t ARMCII_GLOBAL_STATE = { 0 };
 char ARMCII_Strided_methods_str[][10] = { "IOV", "DIRECT" };
 char ARMCII_Iov_methods_str[][10]     = { "AUTO", "CONSRV", "BATCHED", "DIRECT" };
 char ARMCII_Shr_buf_methods_str[][10] = { "COPY", "NOGUARD" };
+char ARMCII_Simd_levels_str[][10]     = { "NONE", "SSE2", "AVX2", "AVX512" };
 
 /** Raise an internal fatal ARMCI error.
   *
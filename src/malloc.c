@@ -62,12 +62,25 @@ int PARMCI_Free(void *ptr) {
   * @param[in]       size Number of bytes to allocate on the local process.
   */
 int ARMCI_Malloc_group(void **base_ptrs, armci_size_t size, ARMCI_Group *group) {
+  return ARMCII_Malloc_group(base_ptrs, size, group, 0);
+}
+
+
+/** Allocate a shared memory segment with gmr_create flags.  Collective.
+  *
+  * @param[out] base_ptrs Array that will contain pointers to the base address of
+  *                       each process' patch of the segment.
+  * @param[in]       size Number of bytes to allocate on the local process.
+  * @param[in]      group Group to allocate on.
+  * @param[in]  gmr_flags GMR_* flags, which must match on all processes.
+  */
+int ARMCII_Malloc_group(void **base_ptrs, armci_size_t size, ARMCI_Group *group, int gmr_flags) {
   int i;
   gmr_t *mreg;
 
   ARMCII_Assert(PARMCI_Initialized());
 
-  mreg = gmr_create(size, base_ptrs, group);
+  mreg = gmr_create(size, base_ptrs, group, gmr_flags);
 
   if (DEBUG_CAT_ENABLED(DEBUG_CAT_ALLOC)) {
 #define BUF_LEN 1000
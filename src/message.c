@@ -65,7 +65,7 @@ void armci_msg_bcast(void *buf_in, int len, int root) {
   MPI_Bcast(buf[0], len, MPI_BYTE, root, ARMCI_GROUP_WORLD.comm);
 
   if (ARMCI_GROUP_WORLD.rank == root)
-    ARMCII_Buf_finish_read_vec(&buf_in, buf, 1, len);
+    ARMCII_Buf_finish_read_vec(buf, 1);
   else
     ARMCII_Buf_finish_write_vec(&buf_in, buf, 1, len);
 }
@@ -165,7 +165,7 @@ void armci_msg_group_bcast_scope(int scope, void *buf_in, int len, int abs_root,
     MPI_Bcast(buf[0], len, MPI_BYTE, grp_root, group->comm);
 
     if (ARMCI_GROUP_WORLD.rank == abs_root)
-      ARMCII_Buf_finish_read_vec(&buf_in, buf, 1, len);
+      ARMCII_Buf_finish_read_vec(buf, 1);
     else
       ARMCII_Buf_finish_write_vec(&buf_in, buf, 1, len);
   } else /* SCOPE_NODE */ {
@@ -188,7 +188,7 @@ void armci_msg_snd(int tag, void *buf_in, int nbytes, int dest) {
 
   ARMCII_Buf_prepare_read_vec(&buf_in, &buf, 1, nbytes);
   MPI_Send(buf[0], nbytes, MPI_BYTE, dest, tag, ARMCI_GROUP_WORLD.comm);
-  ARMCII_Buf_finish_read_vec(&buf_in, buf, 1, nbytes);
+  ARMCII_Buf_finish_read_vec(buf, 1);
 }
 
 
@@ -6,22 +6,39 @@
 #include <stdlib.h>
 
 #include <armci.h>
+#include <armcix.h>
 #include <debug.h>
 #include <gmr.h>
 
+/** Does a handle have operations or a barrier outstanding?
+  */
+static inline int ARMCII_Hdl_active(armci_hdl_t *handle) {
+  if (handle->agg != NULL || handle->barrier != MPI_REQUEST_NULL)
+    return 1;
+#ifdef USE_RMA_REQUESTS
+  return handle->batch_size > 0;
+#else
+  return handle->npairs > 0;
+#endif
+}
+
+
 /** Initialize Non-blocking handle.
   */
 void ARMCI_INIT_HANDLE(armci_hdl_t *handle)
 {
   ARMCII_Assert_msg(handle, "handle is NULL");
   if (1 || handle != NULL) {
+    handle->aggregate = 0;
+    handle->agg       = NULL;
+    handle->barrier   = MPI_REQUEST_NULL;
 #ifdef USE_RMA_REQUESTS
-    handle->batch_size     = 0;
-    handle->single_request = MPI_REQUEST_NULL;
-    handle->request_array  = NULL;
+    handle->batch_size       = 0;
+    handle->request_capacity = 0;
+    handle->request_array    = NULL;
 #else
-    handle->aggregate =  0;
-    handle->target    = -1;
+    handle->npairs     = 0;
+    handle->pair_array = NULL;
 #endif
   } else {
     ARMCII_Warning("ARMCI_INIT_HANDLE given NULL handle.\n");
@@ -29,18 +46,28 @@ void ARMCI_INIT_HANDLE(armci_hdl_t *handle)
   return;
 }
 
-/** Mark a handle as aggregate.
+/** Mark a handle as aggregate.  Small contiguous puts and accumulates on an
+  * aggregate handle are queued and issued together when the handle is waited
+  * on or tested.  The handle must have been initialized with
+  * ARMCI_INIT_HANDLE; operations already on it are completed first.
   */
 void ARMCI_SET_AGGREGATE_HANDLE(armci_hdl_t *handle)
 {
   ARMCII_Assert_msg(handle, "handle is NULL");
   if (1 || handle != NULL) {
+    if (ARMCII_Hdl_active(handle))
+      PARMCI_Wait(handle);
+
+    handle->aggregate = 1;
+    handle->agg       = NULL;
+    handle->barrier   = MPI_REQUEST_NULL;
 #ifdef USE_RMA_REQUESTS
-    handle->batch_size     = 0;
-    handle->single_request = MPI_REQUEST_NULL;
-    handle->request_array  = NULL;
+    handle->batch_size       = 0;
+    handle->request_capacity = 0;
+    handle->request_array    = NULL;
 #else
-    handle->aggregate =  1;
+    handle->npairs     = 0;
+    handle->pair_array = NULL;
 #endif
   } else {
     ARMCII_Warning("ARMCI_SET_AGGREGATE_HANDLE given NULL handle.\n");
@@ -49,18 +76,26 @@ void ARMCI_SET_AGGREGATE_HANDLE(armci_hdl_t *handle)
 }
 
 
-/** Clear an aggregate handle.
+/** Clear an aggregate handle.  Operations still queued on it are completed
+  * first, so that they aren't lost.
   */
 void ARMCI_UNSET_AGGREGATE_HANDLE(armci_hdl_t *handle)
 {
   ARMCII_Assert_msg(handle, "handle is NULL");
   if (1 || handle != NULL) {
+    if (ARMCII_Hdl_active(handle))
+      PARMCI_Wait(handle);
+
+    handle->aggregate = 0;
+    handle->agg       = NULL;
+    handle->barrier   = MPI_REQUEST_NULL;
 #ifdef USE_RMA_REQUESTS
-    handle->batch_size     = 0;
-    handle->single_request = MPI_REQUEST_NULL;
-    handle->request_array  = NULL;
+    handle->batch_size       = 0;
+    handle->request_capacity = 0;
+    handle->request_array    = NULL;
 #else
-    handle->aggregate =  0;
+    handle->npairs     = 0;
+    handle->pair_array = NULL;
 #endif
   } else {
     ARMCII_Warning("ARMCI_UNSET_AGGREGATE_HANDLE given NULL handle.\n");
@@ -99,6 +134,12 @@ int PARMCI_NbPut(void *src, void *dst, int size, int target, armci_hdl_t *handle
   if (target == ARMCI_GROUP_WORLD.rank && src_mreg == NULL) {
       ARMCI_Copy(src, dst, size);
   }
+  /* Small operations on an aggregate handle are queued.  Nothing was issued,
+   * so there is nothing to progress.  Sources in shared memory aren't staged,
+   * they take the guarded path below. */
+  else if (src_mreg == NULL && ARMCII_Agg_put(handle, dst_mreg, src, dst, size, target)) {
+      return 0;
+  }
   else {
       gmr_put(dst_mreg, src, dst, size, target, handle);
   }
@@ -119,7 +160,7 @@ int PARMCI_NbPut(void *src, void *dst, int size, int target, armci_hdl_t *handle
 #endif
 /* -- end weak symbols block -- */
 
-/** Non-blocking get operation.  Note: the implementation is not non-blocking
+/** Non-blocking get operation.
   */
 int PARMCI_NbGet(void *src, void *dst, int size, int target, armci_hdl_t *handle) {
   gmr_t *src_mreg, *dst_mreg;
@@ -176,6 +217,12 @@ int PARMCI_NbAcc(int datatype, void *scale, void *src, void *dst, int bytes, int
 
   ARMCII_Assert_msg(dst_mreg != NULL, "Invalid remote pointer");
 
+  /* Small operations on an aggregate handle are scaled into its staging
+   * buffer and queued, unless the source is in shared memory */
+  if (src_mreg == NULL && ARMCII_Agg_acc(handle, dst_mreg, datatype, scale, src, dst, bytes, target)) {
+    return 0;
+  }
+
   /* Prepare the input data: Apply scaling if needed and acquire the DLA lock if
    * needed.  We hold the DLA lock if (src_buf == src && src_mreg != NULL). */
 
@@ -230,74 +277,76 @@ int PARMCI_NbAcc(int datatype, void *scale, void *src, void *dst, int bytes, int
 #endif
 /* -- end weak symbols block -- */
 
+/** Complete the barrier posted on a handle by ARMCIX_Ibarrier, if any.
+  * Returns nonzero if the handle has no barrier outstanding.
+  */
+static int ARMCII_Hdl_barrier_complete(armci_hdl_t *handle, int blocking)
+{
+  int flag = 1;
+
+  if (handle->barrier == MPI_REQUEST_NULL)
+    return 1;
+
+  if (blocking)
+    MPI_Wait(&handle->barrier, MPI_STATUS_IGNORE);
+  else
+    MPI_Test(&handle->barrier, &flag, MPI_STATUS_IGNORE);
+
+  /* As in ARMCI_Barrier, make remote updates visible to local accesses */
+  if (flag)
+    ARMCII_Sync();
+
+  return flag;
+}
+
+
 /** Wait for a non-blocking operation to finish.
   */
 int PARMCI_Wait(armci_hdl_t* handle)
 {
-#ifdef USE_RMA_REQUESTS
-
   ARMCII_Assert_msg(handle, "handle is NULL");
 
+  /* Issue the operations queued on an aggregate handle */
+  ARMCII_Agg_issue(handle);
+
+#ifdef USE_RMA_REQUESTS
+
   if (handle->batch_size < 0) {
 
     ARMCII_Warning("ARMCI_Wait passed a bogus (uninitialized) handle.\n");
 
-  } else if (handle->batch_size == 0) {
+  } else if (handle->batch_size == 0 && handle->barrier == MPI_REQUEST_NULL) {
 
     ARMCII_Warning("ARMCI_Wait passed an inactive handle.\n");
 
-  } else if (handle->batch_size == 1) {
-
-    if (handle->single_request == MPI_REQUEST_NULL) {
-        ARMCII_Warning("ARMCI_Wait: handle is corrupt (single_request_array is MPI_REQUEST_NULL)\n");
-    }
-    if (handle->request_array != NULL) {
-        //ARMCII_Warning("ARMCI_Wait: handle is corrupt (request_array is not NULL)\n");
-    }
-
-    MPI_Wait( &(handle->single_request), MPI_STATUS_IGNORE );
-
-    handle->batch_size     = 0;
-    handle->single_request = MPI_REQUEST_NULL;
-    handle->request_array  = NULL;
-
-  } else if (handle->batch_size > 1) {
+  } else {
 
-    if (handle->single_request != MPI_REQUEST_NULL) {
-        ARMCII_Warning("ARMCI_Wait: handle is corrupt (single_request_array is not MPI_REQUEST_NULL)\n");
-    }
-    if (handle->request_array == NULL) {
+    if (handle->batch_size > ARMCI_HDL_INLINE_REQUESTS && handle->request_array == NULL) {
         ARMCII_Warning("ARMCI_Wait: handle is corrupt (request_array is NULL)\n");
     }
 
-    MPI_Waitall( handle->batch_size, handle->request_array, MPI_STATUSES_IGNORE );
-    free(handle->request_array);
+    MPI_Waitall( handle->batch_size, gmr_handle_requests(handle), MPI_STATUSES_IGNORE );
 
-    handle->batch_size     = 0;
-    handle->single_request = MPI_REQUEST_NULL;
-    handle->request_array  = NULL;
+    gmr_handle_reset(handle);
+    ARMCII_Hdl_barrier_complete(handle, 1);
   }
 
 #else
 
-  gmr_t *cur_mreg = gmr_list;
-
-  if(handle->aggregate > 0) {
-    while (cur_mreg) {
-      gmr_flushall(cur_mreg, 1); /* local only */
-      cur_mreg = cur_mreg->next;
-    }
-  }
-  else {
-    int proc = handle->target;
-    while (cur_mreg) {
-      gmr_flush(cur_mreg, proc, 1); /* local only */
-      cur_mreg = cur_mreg->next;
-    }
+  if (handle->npairs < 0) {
+    ARMCII_Warning("ARMCI_Wait passed a bogus (uninitialized) handle.\n");
+  } else if (handle->npairs == 0 && handle->barrier == MPI_REQUEST_NULL) {
+    ARMCII_Warning("ARMCI_Wait passed an inactive handle.\n");
+  } else {
+    /* Flush only the windows and targets this handle touched */
+    gmr_wait(handle);
+    ARMCII_Hdl_barrier_complete(handle, 1);
   }
 
 #endif
 
+  ARMCII_Agg_release(handle);
+
   return 0;
 }
 
@@ -322,59 +371,502 @@ int PARMCI_Test(armci_hdl_t* handle)
 
   ARMCII_Assert_msg(handle, "handle is NULL");
 
+  /* Issue the operations queued on an aggregate handle */
+  ARMCII_Agg_issue(handle);
+
   if (handle->batch_size < 0) {
 
     ARMCII_Warning("ARMCI_Test passed a bogus (uninitialized) handle.\n");
 
-  } else if (handle->batch_size == 0) {
+  } else if (handle->batch_size == 0 && handle->barrier == MPI_REQUEST_NULL) {
 
     ARMCII_Warning("ARMCI_Test passed an inactive handle.\n");
+    /* Nothing is outstanding, so it is complete */
+    flag = 1;
 
-  } else if (handle->batch_size == 1) {
+  } else {
 
-    if (handle->single_request == MPI_REQUEST_NULL) {
-        ARMCII_Warning("ARMCI_Test: handle is corrupt (single_request_array is MPI_REQUEST_NULL)\n");
-    }
-    if (handle->request_array != NULL) {
-        ARMCII_Warning("ARMCI_Test: handle is corrupt (request_array is not NULL)\n");
+    if (handle->batch_size > ARMCI_HDL_INLINE_REQUESTS && handle->request_array == NULL) {
+        ARMCII_Warning("ARMCI_Test: handle is corrupt (request_array is NULL)\n");
     }
 
-    MPI_Test( &(handle->single_request), &flag, MPI_STATUS_IGNORE );
+    MPI_Testall( handle->batch_size, gmr_handle_requests(handle), &flag, MPI_STATUSES_IGNORE );
 
     if (flag) {
-        handle->batch_size     = 0;
-        handle->single_request = MPI_REQUEST_NULL;
-        handle->request_array  = NULL;
+        gmr_handle_reset(handle);
+        ARMCII_Agg_release(handle);
     }
 
-  } else if (handle->batch_size > 1) {
+    /* The barrier is tested on its own, since Testall is all-or-nothing */
+    if (!ARMCII_Hdl_barrier_complete(handle, 0))
+        flag = 0;
+  }
+
+  // no error codes are supported so we can do this
+  return (!flag);
+
+#else
+
+  int flag = 0;
+
+  ARMCII_Assert_msg(handle, "handle is NULL");
+
+  /* Issue the operations queued on an aggregate handle */
+  ARMCII_Agg_issue(handle);
+
+  if (handle->npairs < 0) {
+
+    ARMCII_Warning("ARMCI_Test passed a bogus (uninitialized) handle.\n");
+
+  } else if (handle->npairs == 0 && handle->barrier == MPI_REQUEST_NULL) {
+
+    ARMCII_Warning("ARMCI_Test passed an inactive handle.\n");
+    /* Nothing is outstanding, so it is complete */
+    flag = 1;
+
+  } else {
+
+    /* Operations can't be tested without requests (see gmr_wait), so this
+     * blocks until they complete locally, like ARMCI_Wait.  Only the barrier
+     * is tested without blocking. */
+    gmr_wait(handle);
+
+    flag = ARMCII_Hdl_barrier_complete(handle, 0);
+  }
+
+  ARMCII_Agg_release(handle);
+
+  return (!flag);
+
+#endif
+}
+
+
+#ifdef USE_RMA_REQUESTS
+
+/** Requests of several handles gathered into one array, so that a single
+  * MPI_Waitany/Waitsome/Testsome call completes whichever arrives first.
+  */
+typedef struct {
+  int          nreq;       /* Length of reqs and owner                                   */
+  MPI_Request *reqs;       /* Requests of all handles                                    */
+  int         *owner;      /* Handle that each request belongs to                        */
+  int         *first;      /* Index in reqs of each handle's first request               */
+  int         *remaining;  /* Incomplete requests of each handle, -1 if it isn't active  */
+} armcii_hdl_set_t;
+
+
+/** Gather the requests of an array of handles.  Operations queued on
+  * aggregate handles are issued first.  A handle's barrier request, if any,
+  * follows its RMA requests.  Inactive handles are ignored.
+  */
+static void ARMCII_Hdl_set_init(armcii_hdl_set_t *set, int count, armci_hdl_t handles[]) {
+  int h, i, n = 0;
+
+  for (h = 0; h < count; h++) {
+    ARMCII_Agg_issue(&handles[h]);
+    if (handles[h].batch_size > 0)
+      n += handles[h].batch_size;
+    if (handles[h].barrier != MPI_REQUEST_NULL)
+      n++;
+  }
+
+  set->nreq      = 0;
+  set->reqs      = ARMCII_Arena_alloc(n*sizeof(MPI_Request));
+  set->owner     = ARMCII_Arena_alloc(n*sizeof(int));
+  set->first     = ARMCII_Arena_alloc(count*sizeof(int));
+  set->remaining = ARMCII_Arena_alloc(count*sizeof(int));
+
+  for (h = 0; h < count; h++) {
+    MPI_Request *hdl_reqs;
+
+    set->first[h]     = set->nreq;
+    set->remaining[h] = -1;
 
-    if (handle->single_request != MPI_REQUEST_NULL) {
-        ARMCII_Warning("ARMCI_Test: handle is corrupt (single_request_array is not MPI_REQUEST_NULL)\n");
+    if (handles[h].batch_size < 0)
+      ARMCII_Warning("ARMCIX_Waitany/Waitsome/Testsome passed a bogus (uninitialized) handle.\n");
+
+    if (handles[h].batch_size < 0 ||
+        (handles[h].batch_size == 0 && handles[h].barrier == MPI_REQUEST_NULL))
+      continue;
+
+    /* Earlier calls may have completed some of the handle's requests */
+    hdl_reqs          = gmr_handle_requests(&handles[h]);
+    set->remaining[h] = 0;
+
+    for (i = 0; i < handles[h].batch_size; i++) {
+      set->reqs[set->nreq]  = hdl_reqs[i];
+      set->owner[set->nreq] = h;
+      set->nreq++;
+
+      if (hdl_reqs[i] != MPI_REQUEST_NULL)
+        set->remaining[h]++;
     }
-    if (handle->request_array == NULL) {
-        ARMCII_Warning("ARMCI_Test: handle is corrupt (request_array is NULL)\n");
+
+    if (handles[h].barrier != MPI_REQUEST_NULL) {
+      set->reqs[set->nreq]  = handles[h].barrier;
+      set->owner[set->nreq] = h;
+      set->nreq++;
+      set->remaining[h]++;
     }
+  }
+}
 
-    MPI_Testall( handle->batch_size, handle->request_array, &flag, MPI_STATUSES_IGNORE );
 
-    if (flag) {
-        free(handle->request_array);
-        handle->batch_size     = 0;
-        handle->single_request = MPI_REQUEST_NULL;
-        handle->request_array  = NULL;
+/** Release the request set.
+  */
+static void ARMCII_Hdl_set_free(armcii_hdl_set_t *set) {
+  ARMCII_Arena_free(set->remaining);
+  ARMCII_Arena_free(set->first);
+  ARMCII_Arena_free(set->owner);
+  ARMCII_Arena_free(set->reqs);
+}
+
+
+/** Reset handle h, all of whose requests have completed.
+  */
+static void ARMCII_Hdl_set_finish(armcii_hdl_set_t *set, armci_hdl_t handles[], int h) {
+  gmr_handle_reset(&handles[h]);
+  ARMCII_Agg_release(&handles[h]);
+  set->remaining[h] = -1;
+}
+
+
+/** Record that request r of the set completed.  Returns the index of its
+  * handle if that handle is now complete, or -1.
+  */
+static int ARMCII_Hdl_set_complete(armcii_hdl_set_t *set, armci_hdl_t handles[], int r) {
+  const int h = set->owner[r];
+  const int i = r - set->first[h];
+
+  /* MPI freed the request; the handle must not wait on it again */
+  if (i < handles[h].batch_size) {
+    gmr_handle_requests(&handles[h])[i] = MPI_REQUEST_NULL;
+  } else {
+    handles[h].barrier = MPI_REQUEST_NULL;
+    ARMCII_Sync();
+  }
+
+  if (--set->remaining[h] > 0)
+    return -1;
+
+  ARMCII_Hdl_set_finish(set, handles, h);
+
+  return h;
+}
+
+
+/** Complete at least one (blocking) or any number (nonblocking) of an array
+  * of handles.
+  */
+static void ARMCII_Hdl_some(int count, armci_hdl_t handles[], int *outcount, int indices[], int blocking) {
+  armcii_hdl_set_t set;
+  int h, r, nr, n = 0, active = 0, *idx;
+
+  ARMCII_Hdl_set_init(&set, count, handles);
+
+  for (h = 0; h < count; h++) {
+    if (set.remaining[h] >= 0)
+      active = 1;
+
+    if (set.remaining[h] == 0) {
+      ARMCII_Hdl_set_finish(&set, handles, h);
+      indices[n++] = h;
     }
   }
 
-  // no error codes are supported so we can do this
-  return (!flag);
+  idx = ARMCII_Arena_alloc(set.nreq*sizeof(int));
+
+  /* Waitsome need not block if a handle was already complete */
+  while (active && (!blocking || n == 0)) {
+    if (blocking)
+      MPI_Waitsome(set.nreq, set.reqs, &nr, idx, MPI_STATUSES_IGNORE);
+    else
+      MPI_Testsome(set.nreq, set.reqs, &nr, idx, MPI_STATUSES_IGNORE);
+
+    if (nr == MPI_UNDEFINED)
+      break;
+
+    for (r = 0; r < nr; r++) {
+      h = ARMCII_Hdl_set_complete(&set, handles, idx[r]);
+      if (h >= 0)
+        indices[n++] = h;
+    }
+
+    if (!blocking)
+      break;
+  }
+
+  ARMCII_Arena_free(idx);
+  ARMCII_Hdl_set_free(&set);
+
+  *outcount = active ? n : -1;
+}
+
+#else
+
+/** Without RMA requests, handles can only be completed, not tested (see
+  * gmr_wait), so this only waits, and every active handle is completed.
+  */
+static void ARMCII_Hdl_some(int count, armci_hdl_t handles[], int *outcount, int indices[], int blocking) {
+  int h, n = 0, active = 0;
+
+  for (h = 0; h < count; h++) {
+    ARMCII_Agg_issue(&handles[h]);
+
+    if (handles[h].npairs > 0 || handles[h].barrier != MPI_REQUEST_NULL) {
+      PARMCI_Wait(&handles[h]);
+      indices[n++] = h;
+      active = 1;
+    }
+  }
+
+  *outcount = active ? n : -1;
+}
+
+#endif /* USE_RMA_REQUESTS */
+
+
+/** Wait for any one of several nonblocking handles to complete.  Inactive
+  * handles are ignored.
+  *
+  * @param[in]  count   Length of handles.
+  * @param[in]  handles Array of handles.
+  * @param[out] index   Index of the completed handle, or -1 if no handle is active.
+  * @return             Zero on success, error code otherwise.
+  */
+int ARMCIX_Waitany(int count, armci_hdl_t handles[], int *index) {
+#ifdef USE_RMA_REQUESTS
+  armcii_hdl_set_t set;
+  int h, r;
 
+  ARMCII_Hdl_set_init(&set, count, handles);
+
+  *index = -1;
+
+  /* A handle whose requests have all completed needs no waiting */
+  for (h = 0; h < count && *index < 0; h++) {
+    if (set.remaining[h] == 0) {
+      ARMCII_Hdl_set_finish(&set, handles, h);
+      *index = h;
+    }
+  }
+
+  while (*index < 0 && set.nreq > 0) {
+    MPI_Waitany(set.nreq, set.reqs, &r, MPI_STATUS_IGNORE);
+
+    if (r == MPI_UNDEFINED)
+      break;
+
+    *index = ARMCII_Hdl_set_complete(&set, handles, r);
+  }
+
+  ARMCII_Hdl_set_free(&set);
+
+#else
+  int h;
+
+  /* Complete the first active handle by flushing */
+  *index = -1;
+
+  for (h = 0; h < count && *index < 0; h++) {
+    ARMCII_Agg_issue(&handles[h]);
+
+    if (handles[h].npairs > 0 || handles[h].barrier != MPI_REQUEST_NULL) {
+      PARMCI_Wait(&handles[h]);
+      *index = h;
+    }
+  }
+#endif
+
+  return 0;
+}
+
+
+/** Wait for at least one of several nonblocking handles to complete.
+  * Inactive handles are ignored.
+  *
+  * @param[in]  count    Length of handles.
+  * @param[in]  handles  Array of handles.
+  * @param[out] outcount Number of completed handles, or -1 if no handle is active.
+  * @param[out] indices  Indices of the completed handles (length count).
+  * @return              Zero on success, error code otherwise.
+  */
+int ARMCIX_Waitsome(int count, armci_hdl_t handles[], int *outcount, int indices[]) {
+  ARMCII_Hdl_some(count, handles, outcount, indices, 1);
+  return 0;
+}
+
+
+/** Complete whichever of several nonblocking handles have finished, without
+  * blocking.  Inactive handles are ignored.
+  *
+  * @param[in]  count    Length of handles.
+  * @param[in]  handles  Array of handles.
+  * @param[out] outcount Number of completed handles, or -1 if no handle is active.
+  * @param[out] indices  Indices of the completed handles (length count).
+  * @return              Zero on success, error code otherwise.
+  */
+int ARMCIX_Testsome(int count, armci_hdl_t handles[], int *outcount, int indices[]) {
+#ifdef USE_RMA_REQUESTS
+  ARMCII_Hdl_some(count, handles, outcount, indices, 0);
+  return 0;
 #else
-  return PARMCI_Wait(handle);
+  /* Testing would block in gmr_wait, so refuse instead */
+  ARMCII_Warning("ARMCIX_Testsome requires RMA requests, which this build does not use\n");
+  *outcount = 0;
+  return 1;
 #endif
 }
 
 
+/* Completion callbacks: Handles registered with ARMCIX_Callback_hdl are
+ * tested from ARMCIX_Progress, and each callback is invoked once its handle
+ * completes.  The progress thread calls ARMCIX_Progress only when ARMCI was
+ * initialized with MPI_THREAD_MULTIPLE, but polls MPI at any level, so the
+ * table is locked whenever that thread exists.  Without RMA requests, testing
+ * a handle blocks, so no callbacks are registered and polling never tests. */
+
+typedef struct {
+  armci_hdl_t          *handle;
+  armcix_callback_fn_t  fn;
+  void                 *arg;
+} armcii_callback_t;
+
+static armcii_callback_t *callbacks         = NULL;
+static int                ncallbacks        = 0;
+static int                max_callbacks     = 0;
+static int                callbacks_polling = 0;  /* A thread is testing the registered handles */
+
+#ifdef HAVE_PTHREADS
+static pthread_mutex_t callback_mutex = PTHREAD_MUTEX_INITIALIZER;
+#endif
+
+static inline void ARMCII_Callback_lock(void) {
+#ifdef HAVE_PTHREADS
+  if (ARMCII_GLOBAL_STATE.thread_level == MPI_THREAD_MULTIPLE || ARMCII_GLOBAL_STATE.progress_thread) {
+    int ptrc = pthread_mutex_lock(&callback_mutex);
+    ARMCII_Assert(ptrc == 0);
+  }
+#endif
+}
+
+static inline void ARMCII_Callback_unlock(void) {
+#ifdef HAVE_PTHREADS
+  if (ARMCII_GLOBAL_STATE.thread_level == MPI_THREAD_MULTIPLE || ARMCII_GLOBAL_STATE.progress_thread) {
+    int ptrc = pthread_mutex_unlock(&callback_mutex);
+    ARMCII_Assert(ptrc == 0);
+  }
+#endif
+}
+
+
+/** Invoke a callback when the operations on a handle complete, with the same
+  * (local) completion as ARMCI_Wait.  The callback is invoked from
+  * ARMCIX_Progress, or from the progress thread when ARMCI was initialized
+  * with MPI_THREAD_MULTIPLE, and the handle is inactive when it runs.  Until
+  * then the handle must not be used, waited on or tested.
+  *
+  * @param[in] handle Handle of the nonblocking operations.
+  * @param[in] fn     Callback, given the handle and arg.
+  * @param[in] arg    User data for the callback.
+  * @return           Zero on success, error code otherwise (always without
+  *                   RMA requests, in which case the handle is unchanged).
+  */
+int ARMCIX_Callback_hdl(armci_hdl_t *handle, armcix_callback_fn_t fn, void *arg) {
+  ARMCII_Assert_msg(handle, "handle is NULL");
+  ARMCII_Assert_msg(fn, "callback is NULL");
+
+#ifndef USE_RMA_REQUESTS
+  ARMCII_Warning("ARMCIX_Callback_hdl requires RMA requests, which this build does not use\n");
+  return 1;
+#endif
+
+  /* Issue queued operations from the calling thread; the progress thread only
+   * tests their completion */
+  ARMCII_Agg_issue(handle);
+
+  ARMCII_Callback_lock();
+
+  if (ncallbacks == max_callbacks) {
+    max_callbacks = (max_callbacks > 0) ? 2*max_callbacks : 16;
+    callbacks     = realloc(callbacks, max_callbacks*sizeof(armcii_callback_t));
+    ARMCII_Assert(callbacks != NULL);
+  }
+
+  callbacks[ncallbacks].handle = handle;
+  callbacks[ncallbacks].fn     = fn;
+  callbacks[ncallbacks].arg    = arg;
+  ncallbacks++;
+
+  ARMCII_Callback_unlock();
+
+  return 0;
+}
+
+
+/** Test the handles registered for completion callbacks and invoke the
+  * callbacks of those that completed.  Callbacks run without the lock held,
+  * so they may register further callbacks.  A call made from a callback, or
+  * while another thread is polling, returns immediately.
+  *
+  * @param[in] blocking Wait for every registered handle.
+  * @return             Number of callbacks still registered.
+  */
+int ARMCII_Callback_poll(int blocking) {
+  int i = 0, n;
+
+  ARMCII_Callback_lock();
+
+  if (callbacks_polling || ncallbacks == 0) {
+    n = ncallbacks;
+    ARMCII_Callback_unlock();
+    return n;
+  }
+
+  callbacks_polling = 1;
+
+  while (i < ncallbacks) {
+    armcii_callback_t cb = callbacks[i];
+
+    if (ARMCII_Hdl_active(cb.handle)) {
+      if (blocking)
+        PARMCI_Wait(cb.handle);
+      else if (PARMCI_Test(cb.handle)) {
+        i++;
+        continue;
+      }
+    }
+
+    callbacks[i] = callbacks[--ncallbacks];
+
+    ARMCII_Callback_unlock();
+    cb.fn(cb.handle, cb.arg);
+    ARMCII_Callback_lock();
+  }
+
+  callbacks_polling = 0;
+  n = ncallbacks;
+
+  ARMCII_Callback_unlock();
+
+  return n;
+}
+
+
+/** Invoke the callbacks still registered, waiting for their handles, and
+  * release the callback table.
+  */
+void ARMCII_Callback_finalize(void) {
+  while (ARMCII_Callback_poll(1) > 0)
+    ;
+
+  free(callbacks);
+  callbacks     = NULL;
+  max_callbacks = 0;
+}
+
+
 /* -- begin weak symbols block -- */
 #if defined(HAVE_PRAGMA_WEAK)
 #  pragma weak ARMCI_WaitProc = PARMCI_WaitProc
@@ -389,12 +881,7 @@ int PARMCI_Test(armci_hdl_t* handle)
   */
 int PARMCI_WaitProc(int proc)
 {
-  gmr_t *cur_mreg = gmr_list;
-
-  while (cur_mreg) {
-    gmr_flush(cur_mreg, proc, 1); /* local only */
-    cur_mreg = cur_mreg->next;
-  }
+  gmr_flush_dirty(proc, 1); /* local only */
   return 0;
 }
 
@@ -413,12 +900,7 @@ int PARMCI_WaitProc(int proc)
   */
 int PARMCI_WaitAll(void)
 {
-  gmr_t *cur_mreg = gmr_list;
-
-  while (cur_mreg) {
-    gmr_flushall(cur_mreg, 1); /* local only */
-    cur_mreg = cur_mreg->next;
-  }
+  gmr_flushall_dirty(1); /* local only */
   return 0;
 }
 
@@ -4,13 +4,43 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <armci.h>
+#include <armcix.h>
 #include <armci_internals.h>
 #include <gmr.h>
 #include <debug.h>
 
 
+/** Translate an ARMCI RMW operation into the MPI datatype and operation that
+  * implement it.
+  *
+  * @param[in]  op    ARMCI RMW operation
+  * @param[out] type  MPI datatype of the target location
+  * @param[out] rop   MPI operation
+  * @return           Nonzero for swaps, whose operand is the value at the origin
+  */
+static int ARMCII_Rmw_op(int op, MPI_Datatype *type, MPI_Op *rop)
+{
+  if (op == ARMCI_SWAP_LONG || op == ARMCI_FETCH_AND_ADD_LONG)
+    *type = MPI_LONG;
+  else
+    *type = MPI_INT;
+
+  if (op == ARMCI_SWAP || op == ARMCI_SWAP_LONG) {
+    *rop = MPI_REPLACE;
+    return 1;
+  }
+  else if (op == ARMCI_FETCH_AND_ADD || op == ARMCI_FETCH_AND_ADD_LONG)
+    *rop = MPI_SUM;
+  else
+    ARMCII_Error("invalid operation (%d)", op);
+
+  return 0;
+}
+
+
 /* -- begin weak symbols block -- */
 #if defined(HAVE_PRAGMA_WEAK)
 #  pragma weak ARMCI_Rmw = PARMCI_Rmw
@@ -54,21 +84,8 @@ int PARMCI_Rmw(int op, void *ploc, void *prem, int value, int proc)
 
   ARMCII_Assert_msg(dst_mreg != NULL, "Invalid remote pointer");
 
-  if (op == ARMCI_SWAP_LONG || op == ARMCI_FETCH_AND_ADD_LONG) {
-    is_long = 1;
-    type = MPI_LONG;
-  }
-  else
-    type = MPI_INT;
-
-  if (op == ARMCI_SWAP || op == ARMCI_SWAP_LONG) {
-    is_swap = 1;
-    rop = MPI_REPLACE;
-  }
-  else if (op == ARMCI_FETCH_AND_ADD || op == ARMCI_FETCH_AND_ADD_LONG)
-    rop = MPI_SUM;
-  else
-    ARMCII_Error("invalid operation (%d)", op);
+  is_swap = ARMCII_Rmw_op(op, &type, &rop);
+  is_long = (type == MPI_LONG);
 
   /* The request path only has a possible synchronization advantage with
    * USE_REQUEST_ATOMICS=1 and FLUSH_REQUEST_ATOMICS=0.  MPI_Wait provides the
@@ -127,3 +144,212 @@ int PARMCI_Rmw(int op, void *ploc, void *prem, int value, int proc)
 
   return 0;
 }
+
+
+/** Perform a batch of atomic read-modify-write operations, possibly on many
+  * processes and allocations, and return the original values.  All
+  * operations are issued before any is completed, so the batch costs about
+  * one round trip instead of one per operation.  Operations in the batch are
+  * atomic but their relative order is unspecified.
+  *
+  * @param[in]  op     Operation to be performed, as for ARMCI_Rmw.
+  * @param[in]  n      Number of operations.
+  * @param[out] ploc   Location of each operation's original value; the
+  *                    operand of a swap.
+  * @param[in]  prem   Location of each atomic operation.
+  * @param[in]  values Value of each fetch-and-add (ignored for swap, may be NULL).
+  * @param[in]  procs  Process rank of each target.
+  * @return            Zero on success, error code otherwise.
+  */
+int ARMCIX_Rmw_vec(int op, int n, void *ploc[], void *prem[], int values[], int procs[])
+{
+  int          i, is_swap, is_long;
+  MPI_Datatype type;
+  MPI_Op       rop;
+  gmr_t      **mregs;
+  long        *src, *out;  /* Large enough for either type */
+
+  if (n <= 0)
+    return 0;
+
+  is_swap = ARMCII_Rmw_op(op, &type, &rop);
+  is_long = (type == MPI_LONG);
+
+  mregs = ARMCII_Arena_alloc(n*sizeof(gmr_t*));
+  src   = ARMCII_Arena_alloc(n*sizeof(long));
+  out   = ARMCII_Arena_alloc(n*sizeof(long));
+
+  for (i = 0; i < n; i++) {
+    mregs[i] = gmr_lookup(prem[i], procs[i]);
+    ARMCII_Assert_msg(mregs[i] != NULL, "Invalid remote pointer");
+
+    if (is_long)
+      ((long*)src)[i] = is_swap ? *(long*) ploc[i] : values[i];
+    else
+      ((int*)src)[i]  = is_swap ? *(int*) ploc[i]  : values[i];
+  }
+
+  gmr_fetch_and_op_vec(n, mregs, src, out, prem, type, rop, procs);
+
+  for (i = 0; i < n; i++) {
+    if (is_long)
+      *(long*) ploc[i] = ((long*)out)[i];
+    else
+      *(int*) ploc[i]  = ((int*)out)[i];
+  }
+
+  ARMCII_Arena_free(out);
+  ARMCII_Arena_free(src);
+  ARMCII_Arena_free(mregs);
+
+  return 0;
+}
+
+
+/** Nonblocking atomic read-modify-write.  The original value is written to
+  * ploc when the handle completes (ARMCI_Wait, ARMCI_Test, ...); until then
+  * ploc must not be accessed.  Without a handle the operation is blocking.
+  *
+  * @param[in]  op     Operation to be performed, as for ARMCI_Rmw.
+  * @param[out] ploc   Location to store the original value; the operand of a swap.
+  * @param[in]  prem   Location on which to perform atomic operation.
+  * @param[in]  value  Value to add to remote location (ignored for swap).
+  * @param[in]  proc   Process rank for the target buffer.
+  * @param[in]  handle Handle that completes the operation, may be NULL.
+  * @return            Zero on success, error code otherwise.
+  */
+int ARMCIX_NbRmw(int op, void *ploc, void *prem, int value, int proc, armci_hdl_t *handle)
+{
+  int          is_swap;
+  MPI_Datatype type;
+  MPI_Op       rop;
+  gmr_t       *dst_mreg;
+  void        *src;
+
+  /* The operand has to outlive the call, and only a handle can hold it */
+  if (handle == NULL)
+    return PARMCI_Rmw(op, ploc, prem, value, proc);
+
+  is_swap = ARMCII_Rmw_op(op, &type, &rop);
+
+  dst_mreg = gmr_lookup(prem, proc);
+  ARMCII_Assert_msg(dst_mreg != NULL, "Invalid remote pointer");
+
+  src = ARMCII_Agg_stage(handle, sizeof(long), sizeof(long));
+
+  if (type == MPI_LONG)
+    *(long*) src = is_swap ? *(long*) ploc : value;
+  else
+    *(int*) src  = is_swap ? *(int*) ploc  : value;
+
+  gmr_fetch_and_op_nb(dst_mreg, src, ploc, prem, type, rop, proc, handle);
+
+  gmr_progress();
+
+  return 0;
+}
+
+
+/** Translate an extended RMW operation and ARMCI datatype into MPI.  Bitwise
+  * operations need an integer type and complex types aren't supported.
+  */
+static void ARMCII_Rmw_fetch_type(int op, int datatype, MPI_Datatype *type, int *type_size, MPI_Op *rop)
+{
+  const int is_integer = (datatype == ARMCI_ACC_INT || datatype == ARMCI_ACC_LNG);
+
+  if (datatype == ARMCI_ACC_CPL || datatype == ARMCI_ACC_DCP)
+    ARMCII_Error("complex types are not supported by RMW (%d)", datatype);
+
+  ARMCII_Acc_type_translate(datatype, type, type_size);
+
+  switch (op) {
+    case ARMCIX_RMW_SUM:     *rop = MPI_SUM;     break;
+    case ARMCIX_RMW_MIN:     *rop = MPI_MIN;     break;
+    case ARMCIX_RMW_MAX:     *rop = MPI_MAX;     break;
+    case ARMCIX_RMW_REPLACE: *rop = MPI_REPLACE; break;
+    case ARMCIX_RMW_BAND:    *rop = MPI_BAND;    break;
+    case ARMCIX_RMW_BOR:     *rop = MPI_BOR;     break;
+    case ARMCIX_RMW_BXOR:    *rop = MPI_BXOR;    break;
+    default:
+      *rop = MPI_OP_NULL;
+      ARMCII_Error("invalid operation (%d)", op);
+  }
+
+  if (!is_integer && (op == ARMCIX_RMW_BAND || op == ARMCIX_RMW_BOR || op == ARMCIX_RMW_BXOR))
+    ARMCII_Error("bitwise RMW operations require an integer type (%d)", datatype);
+}
+
+
+/** Atomic fetch-and-op on an int, long, float or double location.  Returns
+  * the location's original value.  Atomic with respect to other RMW
+  * operations, as for ARMCI_Rmw.
+  *
+  * @param[in]  op       ARMCIX_RMW_{SUM,MIN,MAX,REPLACE,BAND,BOR,BXOR}
+  * @param[in]  datatype ARMCI_ACC_{INT,LNG,FLT,DBL}; bitwise ops need INT or LNG
+  * @param[out] ploc     Location to store the original value.
+  * @param[in]  prem     Location on which to perform atomic operation.
+  * @param[in]  value    Operand, of the given datatype.
+  * @param[in]  proc     Process rank for the target buffer.
+  * @return              Zero on success, error code otherwise.
+  */
+int ARMCIX_Rmw_fetch_op(int op, int datatype, void *ploc, void *prem, void *value, int proc)
+{
+  MPI_Datatype type;
+  MPI_Op       rop;
+  int          type_size;
+  gmr_t       *dst_mreg;
+  double       src_val, out_val;  /* Private copies, large enough for any type */
+
+  ARMCII_Rmw_fetch_type(op, datatype, &type, &type_size, &rop);
+
+  dst_mreg = gmr_lookup(prem, proc);
+  ARMCII_Assert_msg(dst_mreg != NULL, "Invalid remote pointer");
+
+  memcpy(&src_val, value, type_size);
+
+  // this is a blocking operation
+  gmr_fetch_and_op(dst_mreg, &src_val, &out_val, prem, type, rop, proc);
+
+  memcpy(ploc, &out_val, type_size);
+
+  return 0;
+}
+
+
+/** Atomic compare-and-swap on an int or long location: swap is stored if the
+  * location equals compare.  Returns the location's original value, so the
+  * swap happened if it equals compare.
+  *
+  * @param[in]  datatype ARMCI_ACC_INT or ARMCI_ACC_LNG
+  * @param[out] ploc     Location to store the original value.
+  * @param[in]  prem     Location on which to perform atomic operation.
+  * @param[in]  compare  Value to compare with.
+  * @param[in]  swap     Value to store.
+  * @param[in]  proc     Process rank for the target buffer.
+  * @return              Zero on success, error code otherwise.
+  */
+int ARMCIX_Rmw_cas(int datatype, void *ploc, void *prem, void *compare, void *swap, int proc)
+{
+  MPI_Datatype type;
+  int          type_size;
+  gmr_t       *dst_mreg;
+  long         src_val, cmp_val, out_val;
+
+  if (datatype != ARMCI_ACC_INT && datatype != ARMCI_ACC_LNG)
+    ARMCII_Error("compare-and-swap requires an integer type (%d)", datatype);
+
+  ARMCII_Acc_type_translate(datatype, &type, &type_size);
+
+  dst_mreg = gmr_lookup(prem, proc);
+  ARMCII_Assert_msg(dst_mreg != NULL, "Invalid remote pointer");
+
+  memcpy(&src_val, swap, type_size);
+  memcpy(&cmp_val, compare, type_size);
+
+  // this is a blocking operation
+  gmr_compare_and_swap(dst_mreg, &src_val, &cmp_val, &out_val, prem, type, proc);
+
+  memcpy(ploc, &out_val, type_size);
+
+  return 0;
+}
@@ -0,0 +1,457 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <armci.h>
+#include <armci_internals.h>
+#include <debug.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(ARMCII_NO_SIMD)
+#  define ARMCII_HAVE_X86_SIMD 1
+#  include <immintrin.h>
+#else
+#  define ARMCII_HAVE_X86_SIMD 0
+#endif
+
+
+/* Scaling kernels.  Each kernel scales nelem scalar components of buf_in into
+ * buf_out, so copying and scaling happen in a single pass; complex kernels
+ * process the real/imaginary pairs together.  The input and output never
+ * alias.
+ *
+ * On x86, explicitly vectorized SSE2, AVX2 and AVX-512 variants are compiled
+ * with target attributes and selected at ARMCI_Init time based on what the CPU
+ * supports (ARMCI_SIMD).  The vector kernels perform the same multiplies and
+ * adds as the scalar ones (no FMA contraction), so results are bitwise
+ * identical regardless of the kernel that was selected. */
+
+
+/* Portable kernels */
+
+static void ARMCII_Scale_int(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const int *restrict src_i = (const int*) buf_in;
+  int       *restrict scl_i = (int*) buf_out;
+  const int s = *((const int*) scale);
+  int j;
+
+  for (j = 0; j < nelem; j++)
+    scl_i[j] = src_i[j]*s;
+}
+
+static void ARMCII_Scale_long(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const long *restrict src_l = (const long*) buf_in;
+  long       *restrict scl_l = (long*) buf_out;
+  const long s = *((const long*) scale);
+  int j;
+
+  for (j = 0; j < nelem; j++)
+    scl_l[j] = src_l[j]*s;
+}
+
+static void ARMCII_Scale_float(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *restrict src_f = (const float*) buf_in;
+  float       *restrict scl_f = (float*) buf_out;
+  const float s = *((const float*) scale);
+  int j;
+
+  for (j = 0; j < nelem; j++)
+    scl_f[j] = src_f[j]*s;
+}
+
+static void ARMCII_Scale_double(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *restrict src_d = (const double*) buf_in;
+  double       *restrict scl_d = (double*) buf_out;
+  const double s = *((const double*) scale);
+  int j;
+
+  for (j = 0; j < nelem; j++)
+    scl_d[j] = src_d[j]*s;
+}
+
+static void ARMCII_Scale_complex(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *restrict src_fc = (const float*) buf_in;
+  float       *restrict scl_fc = (float*) buf_out;
+  const float s_r = ((const float*)scale)[0];
+  const float s_c = ((const float*)scale)[1];
+  int j;
+
+  for (j = 0; j < nelem; j += 2) {
+    // Complex multiplication: (a + bi)*(c + di)
+    const float src_fc_j   = src_fc[j];
+    const float src_fc_j_1 = src_fc[j+1];
+    scl_fc[j]   = src_fc_j*s_r   - src_fc_j_1*s_c;
+    scl_fc[j+1] = src_fc_j_1*s_r + src_fc_j*s_c;
+  }
+}
+
+static void ARMCII_Scale_dcomplex(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *restrict src_dc = (const double*) buf_in;
+  double       *restrict scl_dc = (double*) buf_out;
+  const double s_r = ((const double*)scale)[0];
+  const double s_c = ((const double*)scale)[1];
+  int j;
+
+  for (j = 0; j < nelem; j += 2) {
+    // Complex multiplication: (a + bi)*(c + di)
+    const double src_dc_j   = src_dc[j];
+    const double src_dc_j_1 = src_dc[j+1];
+    scl_dc[j]   = src_dc_j*s_r   - src_dc_j_1*s_c;
+    scl_dc[j+1] = src_dc_j_1*s_r + src_dc_j*s_c;
+  }
+}
+
+
+#if ARMCII_HAVE_X86_SIMD
+
+/* SSE2 kernels.  SSE2 has no 32- or 64-bit integer multiply, so the integer
+ * types use the portable kernels at this level.  The complex product is formed
+ * as in*s_r + swap(in)*(-s_c, s_c), which rounds exactly like the scalar
+ * a*c - b*d. */
+
+__attribute__((target("sse2")))
+static void ARMCII_Scale_float_sse2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *src = (const float*) buf_in;
+  float       *dst = (float*) buf_out;
+  const __m128 s   = _mm_set1_ps(*((const float*) scale));
+  int j;
+
+  for (j = 0; j + 4 <= nelem; j += 4)
+    _mm_storeu_ps(dst+j, _mm_mul_ps(_mm_loadu_ps(src+j), s));
+
+  ARMCII_Scale_float(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("sse2")))
+static void ARMCII_Scale_double_sse2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *src = (const double*) buf_in;
+  double       *dst = (double*) buf_out;
+  const __m128d s   = _mm_set1_pd(*((const double*) scale));
+  int j;
+
+  for (j = 0; j + 2 <= nelem; j += 2)
+    _mm_storeu_pd(dst+j, _mm_mul_pd(_mm_loadu_pd(src+j), s));
+
+  ARMCII_Scale_double(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("sse2")))
+static void ARMCII_Scale_complex_sse2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *src = (const float*) buf_in;
+  float       *dst = (float*) buf_out;
+  const float s_r  = ((const float*)scale)[0];
+  const float s_c  = ((const float*)scale)[1];
+  const __m128 sr  = _mm_set1_ps(s_r);
+  const __m128 si  = _mm_setr_ps(-s_c, s_c, -s_c, s_c);
+  int j;
+
+  for (j = 0; j + 4 <= nelem; j += 4) {
+    const __m128 x  = _mm_loadu_ps(src+j);
+    const __m128 xs = _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm_storeu_ps(dst+j, _mm_add_ps(_mm_mul_ps(x, sr), _mm_mul_ps(xs, si)));
+  }
+
+  ARMCII_Scale_complex(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("sse2")))
+static void ARMCII_Scale_dcomplex_sse2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *src = (const double*) buf_in;
+  double       *dst = (double*) buf_out;
+  const double s_r  = ((const double*)scale)[0];
+  const double s_c  = ((const double*)scale)[1];
+  const __m128d sr  = _mm_set1_pd(s_r);
+  const __m128d si  = _mm_setr_pd(-s_c, s_c);
+  int j;
+
+  for (j = 0; j + 2 <= nelem; j += 2) {
+    const __m128d x  = _mm_loadu_pd(src+j);
+    const __m128d xs = _mm_shuffle_pd(x, x, 1);
+    _mm_storeu_pd(dst+j, _mm_add_pd(_mm_mul_pd(x, sr), _mm_mul_pd(xs, si)));
+  }
+
+  ARMCII_Scale_dcomplex(src+j, dst+j, nelem-j, scale);
+}
+
+
+/* AVX2 kernels.  AVX2 has a 32-bit integer multiply but no 64-bit one, so long
+ * uses the portable kernel.  Complex products use addsub on the in*s_r and
+ * swap(in)*s_c partial products.  The AVX kernels clear the upper vector state
+ * before handing the tail to a portable kernel, which may use legacy SSE
+ * encodings (compilers only insert this automatically when optimizing). */
+
+__attribute__((target("avx2")))
+static void ARMCII_Scale_int_avx2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const int    *src = (const int*) buf_in;
+  int          *dst = (int*) buf_out;
+  const __m256i s   = _mm256_set1_epi32(*((const int*) scale));
+  int j;
+
+  for (j = 0; j + 8 <= nelem; j += 8) {
+    const __m256i x = _mm256_loadu_si256((const __m256i*) (src+j));
+    _mm256_storeu_si256((__m256i*) (dst+j), _mm256_mullo_epi32(x, s));
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_int(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx2")))
+static void ARMCII_Scale_float_avx2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *src = (const float*) buf_in;
+  float       *dst = (float*) buf_out;
+  const __m256 s   = _mm256_set1_ps(*((const float*) scale));
+  int j;
+
+  for (j = 0; j + 8 <= nelem; j += 8)
+    _mm256_storeu_ps(dst+j, _mm256_mul_ps(_mm256_loadu_ps(src+j), s));
+
+  _mm256_zeroupper();
+  ARMCII_Scale_float(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx2")))
+static void ARMCII_Scale_double_avx2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *src = (const double*) buf_in;
+  double       *dst = (double*) buf_out;
+  const __m256d s   = _mm256_set1_pd(*((const double*) scale));
+  int j;
+
+  for (j = 0; j + 4 <= nelem; j += 4)
+    _mm256_storeu_pd(dst+j, _mm256_mul_pd(_mm256_loadu_pd(src+j), s));
+
+  _mm256_zeroupper();
+  ARMCII_Scale_double(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx2")))
+static void ARMCII_Scale_complex_avx2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *src = (const float*) buf_in;
+  float       *dst = (float*) buf_out;
+  const __m256 sr  = _mm256_set1_ps(((const float*)scale)[0]);
+  const __m256 si  = _mm256_set1_ps(((const float*)scale)[1]);
+  int j;
+
+  for (j = 0; j + 8 <= nelem; j += 8) {
+    const __m256 x  = _mm256_loadu_ps(src+j);
+    const __m256 xs = _mm256_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1));
+    _mm256_storeu_ps(dst+j, _mm256_addsub_ps(_mm256_mul_ps(x, sr), _mm256_mul_ps(xs, si)));
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_complex(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx2")))
+static void ARMCII_Scale_dcomplex_avx2(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *src = (const double*) buf_in;
+  double       *dst = (double*) buf_out;
+  const __m256d sr  = _mm256_set1_pd(((const double*)scale)[0]);
+  const __m256d si  = _mm256_set1_pd(((const double*)scale)[1]);
+  int j;
+
+  for (j = 0; j + 4 <= nelem; j += 4) {
+    const __m256d x  = _mm256_loadu_pd(src+j);
+    const __m256d xs = _mm256_permute_pd(x, 0x5);
+    _mm256_storeu_pd(dst+j, _mm256_addsub_pd(_mm256_mul_pd(x, sr), _mm256_mul_pd(xs, si)));
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_dcomplex(src+j, dst+j, nelem-j, scale);
+}
+
+
+/* AVX-512 kernels (F and DQ).  There is no 512-bit addsub, so complex products
+ * add everywhere and subtract in the real lanes with a mask. */
+
+__attribute__((target("avx512f")))
+static void ARMCII_Scale_int_avx512(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const int    *src = (const int*) buf_in;
+  int          *dst = (int*) buf_out;
+  const __m512i s   = _mm512_set1_epi32(*((const int*) scale));
+  int j;
+
+  for (j = 0; j + 16 <= nelem; j += 16) {
+    const __m512i x = _mm512_loadu_si512((const void*) (src+j));
+    _mm512_storeu_si512((void*) (dst+j), _mm512_mullo_epi32(x, s));
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_int(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx512f,avx512dq")))
+static void ARMCII_Scale_long_avx512(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const long   *src = (const long*) buf_in;
+  long         *dst = (long*) buf_out;
+  int j = 0;
+
+  if (sizeof(long) == sizeof(long long)) {
+    const __m512i s = _mm512_set1_epi64(*((const long*) scale));
+
+    for (j = 0; j + 8 <= nelem; j += 8) {
+      const __m512i x = _mm512_loadu_si512((const void*) (src+j));
+      _mm512_storeu_si512((void*) (dst+j), _mm512_mullo_epi64(x, s));
+    }
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_long(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx512f")))
+static void ARMCII_Scale_float_avx512(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *src = (const float*) buf_in;
+  float       *dst = (float*) buf_out;
+  const __m512 s   = _mm512_set1_ps(*((const float*) scale));
+  int j;
+
+  for (j = 0; j + 16 <= nelem; j += 16)
+    _mm512_storeu_ps(dst+j, _mm512_mul_ps(_mm512_loadu_ps(src+j), s));
+
+  _mm256_zeroupper();
+  ARMCII_Scale_float(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx512f")))
+static void ARMCII_Scale_double_avx512(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *src = (const double*) buf_in;
+  double       *dst = (double*) buf_out;
+  const __m512d s   = _mm512_set1_pd(*((const double*) scale));
+  int j;
+
+  for (j = 0; j + 8 <= nelem; j += 8)
+    _mm512_storeu_pd(dst+j, _mm512_mul_pd(_mm512_loadu_pd(src+j), s));
+
+  _mm256_zeroupper();
+  ARMCII_Scale_double(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx512f")))
+static void ARMCII_Scale_complex_avx512(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const float *src = (const float*) buf_in;
+  float       *dst = (float*) buf_out;
+  const __m512 sr  = _mm512_set1_ps(((const float*)scale)[0]);
+  const __m512 si  = _mm512_set1_ps(((const float*)scale)[1]);
+  int j;
+
+  for (j = 0; j + 16 <= nelem; j += 16) {
+    const __m512 x  = _mm512_loadu_ps(src+j);
+    const __m512 xr = _mm512_mul_ps(x, sr);
+    const __m512 xi = _mm512_mul_ps(_mm512_permute_ps(x, _MM_SHUFFLE(2, 3, 0, 1)), si);
+    _mm512_storeu_ps(dst+j, _mm512_mask_sub_ps(_mm512_add_ps(xr, xi), 0x5555, xr, xi));
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_complex(src+j, dst+j, nelem-j, scale);
+}
+
+__attribute__((target("avx512f")))
+static void ARMCII_Scale_dcomplex_avx512(const void *buf_in, void *buf_out, int nelem, const void *scale) {
+  const double *src = (const double*) buf_in;
+  double       *dst = (double*) buf_out;
+  const __m512d sr  = _mm512_set1_pd(((const double*)scale)[0]);
+  const __m512d si  = _mm512_set1_pd(((const double*)scale)[1]);
+  int j;
+
+  for (j = 0; j + 8 <= nelem; j += 8) {
+    const __m512d x  = _mm512_loadu_pd(src+j);
+    const __m512d xr = _mm512_mul_pd(x, sr);
+    const __m512d xi = _mm512_mul_pd(_mm512_permute_pd(x, 0x55), si);
+    _mm512_storeu_pd(dst+j, _mm512_mask_sub_pd(_mm512_add_pd(xr, xi), 0x55, xr, xi));
+  }
+
+  _mm256_zeroupper();
+  ARMCII_Scale_dcomplex(src+j, dst+j, nelem-j, scale);
+}
+
+#endif /* ARMCII_HAVE_X86_SIMD */
+
+
+/* Kernel table, indexed by [SIMD level][ARMCI accumulate datatype] */
+
+static const ARMCII_Scale_fn_t ARMCII_Scale_kernels[ARMCII_SIMD_NLEVELS][6] = {
+  { ARMCII_Scale_int,        ARMCII_Scale_long,        ARMCII_Scale_float,
+    ARMCII_Scale_double,     ARMCII_Scale_complex,     ARMCII_Scale_dcomplex },
+#if ARMCII_HAVE_X86_SIMD
+  { ARMCII_Scale_int,        ARMCII_Scale_long,        ARMCII_Scale_float_sse2,
+    ARMCII_Scale_double_sse2, ARMCII_Scale_complex_sse2, ARMCII_Scale_dcomplex_sse2 },
+  { ARMCII_Scale_int_avx2,   ARMCII_Scale_long,        ARMCII_Scale_float_avx2,
+    ARMCII_Scale_double_avx2, ARMCII_Scale_complex_avx2, ARMCII_Scale_dcomplex_avx2 },
+  { ARMCII_Scale_int_avx512, ARMCII_Scale_long_avx512, ARMCII_Scale_float_avx512,
+    ARMCII_Scale_double_avx512, ARMCII_Scale_complex_avx512, ARMCII_Scale_dcomplex_avx512 },
+#endif
+};
+
+
+/** Determine the highest SIMD level supported by this CPU.
+  *
+  * @return ARMCII_SIMD_NONE if no vector kernels are available
+  */
+enum ARMCII_Simd_levels_e ARMCII_Simd_detect(void) {
+#if ARMCII_HAVE_X86_SIMD
+  __builtin_cpu_init();
+
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq"))
+    return ARMCII_SIMD_AVX512;
+  if (__builtin_cpu_supports("avx2"))
+    return ARMCII_SIMD_AVX2;
+  if (__builtin_cpu_supports("sse2"))
+    return ARMCII_SIMD_SSE2;
+#endif
+
+  return ARMCII_SIMD_NONE;
+}
+
+
+/** Look up the scaling kernel for an ARMCI accumulate datatype at the SIMD
+  * level selected by ARMCI_SIMD.
+  *
+  * @param[in]  datatype  ARMCI accumulate datatype
+  * @param[out] type_size Size of one scalar component of the datatype
+  * @return               Scaling kernel
+  */
+ARMCII_Scale_fn_t ARMCII_Scale_kernel(int datatype, int *type_size) {
+  return ARMCII_Scale_kernel_level(datatype, ARMCII_GLOBAL_STATE.simd_level, type_size);
+}
+
+
+/** Look up the scaling kernel for an ARMCI accumulate datatype at a given SIMD
+  * level.  The level must not exceed the one returned by ARMCII_Simd_detect.
+  *
+  * @param[in]  datatype  ARMCI accumulate datatype
+  * @param[in]  level     SIMD level
+  * @param[out] type_size Size of one scalar component of the datatype
+  * @return               Scaling kernel
+  */
+ARMCII_Scale_fn_t ARMCII_Scale_kernel_level(int datatype, enum ARMCII_Simd_levels_e level, int *type_size) {
+  ARMCII_Assert(level >= ARMCII_SIMD_NONE && level < ARMCII_SIMD_NLEVELS);
+
+#if !ARMCII_HAVE_X86_SIMD
+  level = ARMCII_SIMD_NONE;
+#endif
+
+  switch (datatype) {
+    case ARMCI_ACC_INT:
+      *type_size = sizeof(int);
+      break;
+    case ARMCI_ACC_LNG:
+      *type_size = sizeof(long);
+      break;
+    case ARMCI_ACC_FLT:
+    case ARMCI_ACC_CPL:
+      *type_size = sizeof(float);
+      break;
+    case ARMCI_ACC_DBL:
+    case ARMCI_ACC_DCP:
+      *type_size = sizeof(double);
+      break;
+    default:
+      ARMCII_Error("unknown data type (%d)", datatype);
+      return NULL;
+  }
+
+  return ARMCII_Scale_kernels[level][datatype];
+}
@@ -331,7 +331,6 @@ int PARMCI_AccS(int datatype, void *scale,
 
     /* SCALE: copy and scale if requested */
     if (scaled) {
-      armci_giov_t iov;
       int i, nelem;
 
       if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
@@ -343,14 +342,8 @@ int PARMCI_AccS(int datatype, void *scale,
       MPI_Alloc_mem(nelem*mpi_datatype_size, MPI_INFO_NULL, &src_buf);
       ARMCII_Assert(src_buf != NULL);
 
-      /* Shoehorn the strided information into an IOV */
-      ARMCII_Strided_to_iov(&iov, src_ptr, src_stride_ar, src_ptr, src_stride_ar, count, stride_levels);
-
-      for (i = 0; i < iov.ptr_array_len; i++)
-        ARMCII_Buf_acc_scale(iov.src_ptr_array[i], ((uint8_t*)src_buf) + i*iov.bytes, iov.bytes, datatype, scale);
-
-      free(iov.src_ptr_array);
-      free(iov.dst_ptr_array);
+      /* Gather and scale the strided source into the staging buffer in one pass */
+      ARMCII_Buf_acc_scale_strided(src_ptr, src_stride_ar, count, stride_levels, src_buf, datatype, scale);
 
       MPI_Type_contiguous(nelem, mpi_datatype, &src_type);
     }
@@ -263,7 +263,6 @@ int PARMCI_NbAccS(int datatype, void *scale,
 
     /* SCALE: copy and scale if requested */
     if (scaled) {
-      armci_giov_t iov;
       int i, nelem;
 
       if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
@@ -275,14 +274,8 @@ int PARMCI_NbAccS(int datatype, void *scale,
       MPI_Alloc_mem(nelem*mpi_datatype_size, MPI_INFO_NULL, &src_buf);
       ARMCII_Assert(src_buf != NULL);
 
-      /* Shoehorn the strided information into an IOV */
-      ARMCII_Strided_to_iov(&iov, src_ptr, src_stride_ar, src_ptr, src_stride_ar, count, stride_levels);
-
-      for (i = 0; i < iov.ptr_array_len; i++)
-        ARMCII_Buf_acc_scale(iov.src_ptr_array[i], ((uint8_t*)src_buf) + i*iov.bytes, iov.bytes, datatype, scale);
-
-      free(iov.src_ptr_array);
-      free(iov.dst_ptr_array);
+      /* Gather and scale the strided source into the staging buffer in one pass */
+      ARMCII_Buf_acc_scale_strided(src_ptr, src_stride_ar, count, stride_levels, src_buf, datatype, scale);
 
       MPI_Type_contiguous(nelem, mpi_datatype, &src_type);
     }
@@ -361,3 +354,148 @@ int PARMCI_NbAccS(int datatype, void *scale,
 
   return err;
 }
+
+
+/** Staged vector form of one strided descriptor of a multi-target operation
+  */
+typedef struct {
+  armci_giov_t iov;
+  void       **bufs;     /* Private (staged) local buffers */
+} armcii_multi_entry_t;
+
+
+/** Issue a batch of strided operations, each to its own target, and complete
+  * them together.  Every descriptor is issued as a nonblocking vector operation
+  * on a single handle, so the latencies of the targets overlap; local staging
+  * buffers are released once the whole batch has completed.
+  */
+static int ARMCII_Strided_multi(enum ARMCII_Op_e op, int datatype, void *scale,
+                                armcix_strided_desc_t *desc, int ndesc)
+{
+  armcii_multi_entry_t *ent;
+  armci_hdl_t handle;
+  int i;
+
+  if (ndesc <= 0)
+    return 0;
+
+  ent = malloc(ndesc*sizeof(armcii_multi_entry_t));
+  ARMCII_Assert(ent != NULL);
+
+  ARMCI_INIT_HANDLE(&handle);
+
+  for (i = 0; i < ndesc; i++) {
+    armci_giov_t *iov = &ent[i].iov;
+    void **rem;
+    int overlapping, same_alloc;
+
+    ARMCII_Strided_to_iov(iov, desc[i].src_ptr, desc[i].src_stride_ar, desc[i].dst_ptr,
+                          desc[i].dst_stride_ar, desc[i].count, desc[i].stride_levels);
+
+    ent[i].bufs = NULL;
+
+    if (iov->ptr_array_len == 0 || iov->bytes == 0) continue; // NOP //
+
+    rem = (op == ARMCII_OP_GET) ? iov->src_ptr_array : iov->dst_ptr_array;
+
+    overlapping = ARMCII_Iov_check_overlap(iov->dst_ptr_array, iov->ptr_array_len, iov->bytes);
+    same_alloc  = ARMCII_Iov_check_same_allocation(rem, iov->ptr_array_len, desc[i].proc);
+
+    switch (op) {
+      case ARMCII_OP_PUT:
+        ARMCII_Buf_prepare_read_vec(iov->src_ptr_array, &ent[i].bufs, iov->ptr_array_len, iov->bytes);
+        ARMCII_Iov_op_dispatch(op, ent[i].bufs, iov->dst_ptr_array, iov->ptr_array_len, iov->bytes, 0,
+                               overlapping, same_alloc, desc[i].proc, 0 /* nonblocking */, &handle);
+        break;
+      case ARMCII_OP_GET:
+        ARMCII_Buf_prepare_write_vec(iov->dst_ptr_array, &ent[i].bufs, iov->ptr_array_len, iov->bytes);
+        ARMCII_Iov_op_dispatch(op, iov->src_ptr_array, ent[i].bufs, iov->ptr_array_len, iov->bytes, 0,
+                               overlapping, same_alloc, desc[i].proc, 0 /* nonblocking */, &handle);
+        break;
+      case ARMCII_OP_ACC:
+        ARMCII_Buf_prepare_acc_vec(iov->src_ptr_array, &ent[i].bufs, iov->ptr_array_len, iov->bytes,
+                                   datatype, scale);
+        ARMCII_Iov_op_dispatch(op, ent[i].bufs, iov->dst_ptr_array, iov->ptr_array_len, iov->bytes, datatype,
+                               overlapping, same_alloc, desc[i].proc, 0 /* nonblocking */, &handle);
+        break;
+      default:
+        ARMCII_Error("unknown operation (%d)", op);
+        return 1;
+    }
+  }
+
+  /* Complete the whole batch at once */
+#ifdef USE_RMA_REQUESTS
+  if (handle.batch_size > 0)
+#else
+  if (handle.npairs > 0)
+#endif
+    PARMCI_Wait(&handle);
+
+  for (i = 0; i < ndesc; i++) {
+    armci_giov_t *iov = &ent[i].iov;
+
+    if (ent[i].bufs != NULL) {
+      switch (op) {
+        case ARMCII_OP_PUT:
+          ARMCII_Buf_finish_read_vec(ent[i].bufs, iov->ptr_array_len);
+          break;
+        case ARMCII_OP_GET:
+          ARMCII_Buf_finish_write_vec(iov->dst_ptr_array, ent[i].bufs, iov->ptr_array_len, iov->bytes);
+          break;
+        case ARMCII_OP_ACC:
+          ARMCII_Buf_finish_acc_vec(ent[i].bufs, iov->ptr_array_len);
+          break;
+        default:
+          break;
+      }
+    }
+
+    free(iov->src_ptr_array);
+    free(iov->dst_ptr_array);
+  }
+
+  free(ent);
+
+  gmr_progress();
+
+  return 0;
+}
+
+
+/** Blocking strided put to several targets.  The transfers are issued
+  * together and their latencies overlap.
+  *
+  * @param[in] desc  Array of strided transfer descriptors, one per transfer.
+  * @param[in] ndesc Length of desc.
+  * @return          Zero on success, error code otherwise.
+  */
+int ARMCIX_PutS_multi(armcix_strided_desc_t *desc, int ndesc) {
+  return ARMCII_Strided_multi(ARMCII_OP_PUT, 0, NULL, desc, ndesc);
+}
+
+
+/** Blocking strided get from several targets.  The transfers are issued
+  * together and their latencies overlap.
+  *
+  * @param[in] desc  Array of strided transfer descriptors, one per transfer.
+  * @param[in] ndesc Length of desc.
+  * @return          Zero on success, error code otherwise.
+  */
+int ARMCIX_GetS_multi(armcix_strided_desc_t *desc, int ndesc) {
+  return ARMCII_Strided_multi(ARMCII_OP_GET, 0, NULL, desc, ndesc);
+}
+
+
+/** Blocking strided accumulate to several targets.  The transfers are issued
+  * together and their latencies overlap.
+  *
+  * @param[in] datatype ARMCI data type of the transfers.
+  * @param[in] scale    Pointer to the value that input data should be scaled by.
+  * @param[in] desc     Array of strided transfer descriptors, one per transfer.
+  * @param[in] ndesc    Length of desc.
+  * @return             Zero on success, error code otherwise.
+  */
+int ARMCIX_AccS_multi(int datatype, void *scale, armcix_strided_desc_t *desc, int ndesc) {
+  return ARMCII_Strided_multi(ARMCII_OP_ACC, datatype, scale, desc, ndesc);
+}
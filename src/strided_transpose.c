@@ -0,0 +1,334 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <armci.h>
+#include <armcix.h>
+#include <armci_internals.h>
+#include <gmr.h>
+#include <debug.h>
+
+
+/** Compute the per-dimension element counts and byte strides of a transposed
+  * strided transfer.  Dimensions are listed in the order of the local array;
+  * local dimension i is stored in dimension perm[i] of the remote array.
+  *
+  * @param[in]  loc_stride_ar  Local array of stride distances in bytes
+  * @param[in]  rem_stride_ar  Remote array of stride distances in bytes
+  * @param[in]  count          Local block size in each dimension (count[0] in bytes)
+  * @param[in]  stride_levels  Number of levels of striding
+  * @param[in]  perm           Remote dimension of each local dimension
+  * @param[in]  elem_size      Size in bytes of the elements being transposed
+  * @param[out] dims           Number of elements in each local dimension
+  * @param[out] loc_disp       Local byte stride of each local dimension
+  * @param[out] rem_disp       Remote byte stride of each local dimension
+  */
+static void ARMCII_Transpose_dims(int loc_stride_ar[], int rem_stride_ar[], int count[],
+                                  int stride_levels, int perm[], int elem_size, int dims[],
+                                  MPI_Aint loc_disp[], MPI_Aint rem_disp[])
+{
+  int  i;
+  char seen[stride_levels+1];
+
+  ARMCII_Assert_msg(elem_size > 0 && (count[0] % elem_size) == 0,
+                    "Leading dimension is not a multiple of the element size");
+
+  memset(seen, 0, sizeof(seen));
+
+  for (i = 0; i < stride_levels+1; i++) {
+    ARMCII_Assert_msg(perm[i] >= 0 && perm[i] <= stride_levels && !seen[perm[i]],
+                      "Invalid dimension permutation");
+    seen[perm[i]] = 1;
+
+    dims[i]     = (i == 0) ? count[0]/elem_size : count[i];
+    loc_disp[i] = (i == 0) ? elem_size : loc_stride_ar[i-1];
+    rem_disp[i] = (perm[i] == 0) ? elem_size : rem_stride_ar[perm[i]-1];
+  }
+}
+
+
+/** Build an MPI datatype that visits a buffer in the order of the local
+  * dimensions of a transposed transfer.  The innermost run of contiguous bytes
+  * is given by run; dimensions below first have been folded into the run.
+  *
+  * @param[in]  dims           Number of elements in each dimension
+  * @param[in]  disp           Byte stride of each dimension
+  * @param[in]  first          First dimension not folded into the run
+  * @param[in]  stride_levels  Number of levels of striding
+  * @param[in]  run            Length in bytes of each contiguous run
+  * @param[out] new_type       New MPI type for the transfer
+  */
+static void ARMCII_Transpose_to_dtype(int dims[], MPI_Aint disp[], int first, int stride_levels,
+                                      int run, MPI_Datatype *new_type)
+{
+  MPI_Datatype type, next;
+  int i;
+
+  MPI_Type_contiguous(run, MPI_BYTE, &type);
+
+  for (i = first; i < stride_levels+1; i++) {
+    MPI_Type_create_hvector(dims[i], 1, disp[i], type, &next);
+    MPI_Type_free(&type);
+    type = next;
+  }
+
+  *new_type = type;
+}
+
+
+/** Translate a transposed transfer into a list of contiguous runs.  Runs are
+  * listed in the order of the local dimensions.
+  *
+  * @param[in]  loc_ptr        Local starting address
+  * @param[in]  rem_ptr        Remote starting address
+  * @param[in]  dims           Number of elements in each dimension
+  * @param[in]  loc_disp       Local byte stride of each dimension
+  * @param[in]  rem_disp       Remote byte stride of each dimension
+  * @param[in]  first          First dimension not folded into the run
+  * @param[in]  stride_levels  Number of levels of striding
+  * @param[out] loc_ptrs       Local address of each run
+  * @param[out] rem_ptrs       Remote address of each run
+  *
+  * @return                    Number of runs
+  */
+static int ARMCII_Transpose_to_iov(void *loc_ptr, void *rem_ptr, int dims[], MPI_Aint loc_disp[],
+                                   MPI_Aint rem_disp[], int first, int stride_levels,
+                                   void **loc_ptrs, void **rem_ptrs)
+{
+  int idx[stride_levels+1];
+  int i, xfer;
+
+  for (i = 0; i < stride_levels+1; i++)
+    idx[i] = 0;
+
+  for (xfer = 0; first > stride_levels || idx[stride_levels] < dims[stride_levels]; xfer++) {
+    MPI_Aint off_loc = 0, off_rem = 0;
+
+    for (i = first; i < stride_levels+1; i++) {
+      off_loc += loc_disp[i]*idx[i];
+      off_rem += rem_disp[i]*idx[i];
+    }
+
+    loc_ptrs[xfer] = ((uint8_t*)loc_ptr) + off_loc;
+    rem_ptrs[xfer] = ((uint8_t*)rem_ptr) + off_rem;
+
+    if (first > stride_levels) {
+      xfer++;
+      break;
+    }
+
+    // Increment innermost index and propagate "carry" overflows outward
+    idx[first] += 1;
+
+    for (i = first; i < stride_levels; i++) {
+      if (idx[i] >= dims[i]) {
+        idx[i]    = 0;
+        idx[i+1] += 1;
+      }
+    }
+  }
+
+  return xfer;
+}
+
+
+/** Issue a transposed strided transfer.  Shared by the put and get paths.
+  */
+static int ARMCII_Transpose_op(enum ARMCII_Op_e op, void *loc_ptr, int loc_stride_ar[],
+                               void *rem_ptr, int rem_stride_ar[], int count[], int stride_levels,
+                               int perm[], int elem_size, int proc)
+{
+  int       dims[stride_levels+1];
+  MPI_Aint  loc_disp[stride_levels+1], rem_disp[stride_levels+1];
+  int       i, first, run, nrun, size;
+  gmr_t    *mreg, *gmr_loc = NULL;
+
+  ARMCII_Transpose_dims(loc_stride_ar, rem_stride_ar, count, stride_levels, perm,
+                        elem_size, dims, loc_disp, rem_disp);
+
+  /* If the leading dimension is not moved, whole rows stay contiguous on both sides */
+  if (perm[0] == 0) {
+    first = 1;
+    run   = count[0];
+  } else {
+    first = 0;
+    run   = elem_size;
+  }
+
+  for (i = first, nrun = 1; i < stride_levels+1; i++)
+    nrun *= dims[i];
+
+  size = nrun*run;
+
+  if (size == 0)
+    return 0;
+
+  mreg = gmr_lookup(rem_ptr, proc);
+  ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
+
+  /* If NOGUARD is set, assume the buffer is not shared */
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD)
+    gmr_loc = gmr_lookup(loc_ptr, ARMCI_GROUP_WORLD.rank);
+
+  /* Local operation: transpose directly between the two buffers */
+  if (proc == ARMCI_GROUP_WORLD.rank && gmr_loc == NULL) {
+    void **loc_ptrs = malloc(nrun*sizeof(void*));
+    void **rem_ptrs = malloc(nrun*sizeof(void*));
+
+    ARMCII_Assert(loc_ptrs != NULL && rem_ptrs != NULL);
+
+    ARMCII_Transpose_to_iov(loc_ptr, rem_ptr, dims, loc_disp, rem_disp, first, stride_levels,
+                            loc_ptrs, rem_ptrs);
+
+    if (op == ARMCII_OP_PUT) {
+      for (i = 0; i < nrun; i++)
+        ARMCI_Copy(loc_ptrs[i], rem_ptrs[i], run);
+    } else {
+      for (i = 0; i < nrun; i++)
+        ARMCI_Copy(rem_ptrs[i], loc_ptrs[i], run);
+    }
+
+    free(loc_ptrs);
+    free(rem_ptrs);
+  }
+
+  /* IOV: Datatypes are disabled for strided operations, move the runs as a vector */
+  else if (ARMCII_GLOBAL_STATE.strided_method != ARMCII_STRIDED_DIRECT) {
+    armci_giov_t iov;
+
+    iov.bytes         = run;
+    iov.ptr_array_len = nrun;
+    iov.src_ptr_array = malloc(nrun*sizeof(void*));
+    iov.dst_ptr_array = malloc(nrun*sizeof(void*));
+
+    ARMCII_Assert(iov.src_ptr_array != NULL && iov.dst_ptr_array != NULL);
+
+    if (op == ARMCII_OP_PUT) {
+      ARMCII_Transpose_to_iov(loc_ptr, rem_ptr, dims, loc_disp, rem_disp, first, stride_levels,
+                              iov.src_ptr_array, iov.dst_ptr_array);
+      PARMCI_PutV(&iov, 1, proc);
+    } else {
+      ARMCII_Transpose_to_iov(loc_ptr, rem_ptr, dims, loc_disp, rem_disp, first, stride_levels,
+                              iov.dst_ptr_array, iov.src_ptr_array);
+      PARMCI_GetV(&iov, 1, proc);
+    }
+
+    free(iov.src_ptr_array);
+    free(iov.dst_ptr_array);
+  }
+
+  /* DIRECT: The target-side datatype performs the transpose inside MPI */
+  else {
+    void        *loc_buf = NULL;
+    MPI_Datatype loc_type, rem_type;
+
+    /* COPY: Guard shared buffers.  The staging buffer holds the local data
+     * packed in the order of the local dimensions. */
+    if (gmr_loc != NULL && ARMCII_GLOBAL_STATE.shr_buf_method == ARMCII_SHR_BUF_COPY) {
+      MPI_Alloc_mem(size, MPI_INFO_NULL, &loc_buf);
+      ARMCII_Assert(loc_buf != NULL);
+
+      if (op == ARMCII_OP_PUT)
+        armci_write_strided(loc_ptr, stride_levels, loc_stride_ar, count, loc_buf);
+
+      MPI_Type_contiguous(size, MPI_BYTE, &loc_type);
+    }
+    else {
+      if (gmr_loc != NULL)
+        gmr_sync(gmr_loc);
+
+      loc_buf = loc_ptr;
+      ARMCII_Transpose_to_dtype(dims, loc_disp, first, stride_levels, run, &loc_type);
+    }
+
+    ARMCII_Transpose_to_dtype(dims, rem_disp, first, stride_levels, run, &rem_type);
+
+    MPI_Type_commit(&loc_type);
+    MPI_Type_commit(&rem_type);
+
+    if (op == ARMCII_OP_PUT) {
+      gmr_put_typed(mreg, loc_buf, 1, loc_type, rem_ptr, 1, rem_type, proc, NULL /* handle */);
+      gmr_flush(mreg, proc, 1); /* flush_local */
+    } else {
+      gmr_get_typed(mreg, rem_ptr, 1, rem_type, loc_buf, 1, loc_type, proc, NULL /* handle */);
+      gmr_flush(mreg, proc, 0);
+    }
+
+    MPI_Type_free(&loc_type);
+    MPI_Type_free(&rem_type);
+
+    /* COPY: Finish the transfer and free the staging buffer */
+    if (loc_buf != loc_ptr) {
+      if (op == ARMCII_OP_GET)
+        armci_read_strided(loc_ptr, stride_levels, loc_stride_ar, count, loc_buf);
+
+      MPI_Free_mem(loc_buf);
+    }
+  }
+
+  return 0;
+}
+
+
+/** Blocking strided put where the remote array is a permutation of the
+  * dimensions of the local array.  The transpose is performed by the
+  * target-side datatype, so no local scratch copy of the array is needed.
+  *
+  * Local dimension i is stored in remote dimension perm[i].  Dimension 0 of
+  * both arrays is contiguous in units of elem_size bytes.
+  *
+  * @param[in] src_ptr         Source starting address of the local array.
+  * @param[in] src_stride_ar   Source array of stride distances in bytes.
+  * @param[in] dst_ptr         Destination starting address of the remote array.
+  * @param[in] dst_stride_ar   Destination array of stride distances in bytes.
+  * @param[in] count           Block size in each local dimension. count[0] should be
+  *                            the number of bytes of contiguous data in leading dimension.
+  * @param[in] stride_levels   The level of strides.
+  * @param[in] perm            Remote dimension of each local dimension.
+  * @param[in] elem_size       Size in bytes of each array element.
+  * @param[in] proc            Remote process ID (destination).
+  *
+  * @return                    Zero on success, error code otherwise.
+  */
+int ARMCIX_PutS_transpose(void *src_ptr, int src_stride_ar[/*stride_levels*/],
+                          void *dst_ptr, int dst_stride_ar[/*stride_levels*/],
+                          int count[/*stride_levels+1*/], int stride_levels,
+                          int perm[/*stride_levels+1*/], int elem_size, int proc) {
+
+  return ARMCII_Transpose_op(ARMCII_OP_PUT, src_ptr, src_stride_ar, dst_ptr, dst_stride_ar,
+                             count, stride_levels, perm, elem_size, proc);
+}
+
+
+/** Blocking strided get where the remote array is a permutation of the
+  * dimensions of the local array.  The transpose is performed by the
+  * target-side datatype, so no local scratch copy of the array is needed.
+  *
+  * Local dimension i is read from remote dimension perm[i].  Dimension 0 of
+  * both arrays is contiguous in units of elem_size bytes.
+  *
+  * @param[in] src_ptr         Source starting address of the remote array.
+  * @param[in] src_stride_ar   Source array of stride distances in bytes.
+  * @param[in] dst_ptr         Destination starting address of the local array.
+  * @param[in] dst_stride_ar   Destination array of stride distances in bytes.
+  * @param[in] count           Block size in each local dimension. count[0] should be
+  *                            the number of bytes of contiguous data in leading dimension.
+  * @param[in] stride_levels   The level of strides.
+  * @param[in] perm            Remote dimension of each local dimension.
+  * @param[in] elem_size       Size in bytes of each array element.
+  * @param[in] proc            Remote process ID (source).
+  *
+  * @return                    Zero on success, error code otherwise.
+  */
+int ARMCIX_GetS_transpose(void *src_ptr, int src_stride_ar[/*stride_levels*/],
+                          void *dst_ptr, int dst_stride_ar[/*stride_levels*/],
+                          int count[/*stride_levels+1*/], int stride_levels,
+                          int perm[/*stride_levels+1*/], int elem_size, int proc) {
+
+  return ARMCII_Transpose_op(ARMCII_OP_GET, dst_ptr, dst_stride_ar, src_ptr, src_stride_ar,
+                             count, stride_levels, perm, elem_size, proc);
+}
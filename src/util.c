@@ -43,6 +43,30 @@ void PARMCI_Barrier(void) {
   ARMCII_Sync();
 }
 
+
+/** Nonblocking barrier.  Collective on the world group, like ARMCI_Barrier.
+  * One-sided operations issued before the call, including those on the
+  * handle, are completed remotely first; the barrier itself completes under
+  * ARMCI_Wait or ARMCI_Test on the handle.
+  *
+  * @param[in] handle Initialized handle, may carry other operations.
+  * @return           Zero on success, error code otherwise.
+  */
+int ARMCIX_Ibarrier(armci_hdl_t *handle) {
+  ARMCII_Assert_msg(handle, "handle is NULL");
+  ARMCII_Assert_msg(handle->barrier == MPI_REQUEST_NULL, "handle already has a barrier outstanding");
+
+  /* Only the barrier is split-phase; outstanding operations are completed
+   * here.  With dirty tracking only the targets with incomplete operations
+   * are flushed. */
+  ARMCII_Agg_issue(handle);
+  PARMCI_AllFence();
+
+  MPI_Ibarrier(ARMCI_GROUP_WORLD.comm, &handle->barrier);
+
+  return 0;
+}
+
 /* -- begin weak symbols block -- */
 #if defined(HAVE_PRAGMA_WEAK)
 #  pragma weak ARMCI_Fence = PARMCI_Fence
@@ -58,12 +82,7 @@ void PARMCI_Barrier(void) {
   * @param[in] proc Process to target
   */
 void PARMCI_Fence(int proc) {
-  gmr_t *cur_mreg = gmr_list;
-
-  while (cur_mreg) {
-    gmr_flush(cur_mreg, proc, 0);
-    cur_mreg = cur_mreg->next;
-  }
+  gmr_flush_dirty(proc, 0);
   return;
 }
 
@@ -81,12 +100,7 @@ void PARMCI_Fence(int proc) {
 /** Wait for remote completion on all one-sided operations.
   */
 void PARMCI_AllFence(void) {
-  gmr_t *cur_mreg = gmr_list;
-
-  while (cur_mreg) {
-    gmr_flushall(cur_mreg, 0);
-    cur_mreg = cur_mreg->next;
-  }
+  gmr_flushall_dirty(0);
   return;
 }
 
@@ -205,6 +219,7 @@ void ARMCII_Getenv_char(char * output, const char *varname, const char *default_
 void ARMCIX_Progress(void)
 {
     gmr_progress();
+    ARMCII_Callback_poll(0);
 }
 
 /** Determine if a window supports the unified memory model.
@@ -235,10 +250,5 @@ int ARMCII_Is_win_unified(MPI_Win win)
 /** Sync all windows
   */
 void ARMCII_Sync(void) {
-  gmr_t *cur_mreg = gmr_list;
-
-  while (cur_mreg) {
-    gmr_sync(cur_mreg);
-    cur_mreg = cur_mreg->next;
-  }
+  gmr_sync_all();
 }
@@ -4,6 +4,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <limits.h>
 
 #include <armci.h>
@@ -11,29 +12,105 @@
 #include <debug.h>
 #include <gmr.h>
 
+
 #ifndef NO_USE_CTREE
-#include <conflict_tree.h>
-#endif
+/** Address range [lo, hi] covered by an IOV segment
+  */
+typedef struct {
+  uintptr_t lo;
+  uintptr_t hi;
+} armcii_iov_range_t;
+
+#define ARMCII_RADIX_BITS    8
+#define ARMCII_RADIX_BUCKETS (1 << ARMCII_RADIX_BITS)
+#define ARMCII_RADIX_PASSES  ((int)(sizeof(uintptr_t)*8/ARMCII_RADIX_BITS))
+#define ARMCII_RADIX_MIN     64   /* Shorter arrays are insertion sorted */
+
+/** Sort address ranges by their low address.  Short arrays are insertion
+  * sorted; longer ones are LSD radix sorted, skipping digits on which all
+  * addresses agree (typically the high bytes).
+  *
+  * @param[in] ranges Ranges to sort
+  * @param[in] tmp    Scratch space for count ranges
+  * @param[in] count  Number of ranges
+  * @return           Pointer to the sorted ranges, either ranges or tmp
+  */
+static armcii_iov_range_t *ARMCII_Iov_sort_ranges(armcii_iov_range_t *ranges, armcii_iov_range_t *tmp, int count) {
+  int hist[ARMCII_RADIX_PASSES][ARMCII_RADIX_BUCKETS];
+  int i, p;
+
+  if (count < ARMCII_RADIX_MIN) {
+    for (i = 1; i < count; i++) {
+      armcii_iov_range_t r = ranges[i];
+      int j = i - 1;
 
+      for ( ; j >= 0 && ranges[j].lo > r.lo; j--)
+        ranges[j+1] = ranges[j];
 
-/** Check an I/O vector operation's buffers for overlap.
-  *
-  * @param[in] iov      Vector of transfer information.
-  * @return             Logical true when regions overlap, 0 otherwise.
+      ranges[j+1] = r;
+    }
+
+    return ranges;
+  }
+
+  /* Histogram every digit in a single pass over the data */
+  memset(hist, 0, sizeof(hist));
+
+  for (i = 0; i < count; i++)
+    for (p = 0; p < ARMCII_RADIX_PASSES; p++)
+      hist[p][(ranges[i].lo >> (p*ARMCII_RADIX_BITS)) & (ARMCII_RADIX_BUCKETS-1)]++;
+
+  for (p = 0; p < ARMCII_RADIX_PASSES; p++) {
+    const int shift = p*ARMCII_RADIX_BITS;
+    armcii_iov_range_t *swap;
+    int b, sum;
+
+    /* All addresses have the same digit: the pass would not move anything */
+    if (hist[p][(ranges[0].lo >> shift) & (ARMCII_RADIX_BUCKETS-1)] == count)
+      continue;
+
+    for (b = 0, sum = 0; b < ARMCII_RADIX_BUCKETS; b++) {
+      const int n = hist[p][b];
+      hist[p][b] = sum;
+      sum += n;
+    }
+
+    for (i = 0; i < count; i++)
+      tmp[hist[p][(ranges[i].lo >> shift) & (ARMCII_RADIX_BUCKETS-1)]++] = ranges[i];
+
+    swap   = ranges;
+    ranges = tmp;
+    tmp    = swap;
+  }
+
+  return ranges;
+}
+#endif /* NO_USE_CTREE */
+
+
+/** Check buffers of size bytes, or of sizes[i] bytes when sizes is given, for
+  * overlap.  Empty buffers never overlap.
   */
-int ARMCII_Iov_check_overlap(void **ptrs, int count, int size) {
+static int ARMCII_Iov_check_overlap_core(void **ptrs, int count, int size, const int *sizes, int always) {
 #ifndef NO_CHECK_OVERLAP
 #ifdef NO_USE_CTREE
   int i, j;
 
-  if (!ARMCII_GLOBAL_STATE.iov_checks) return 0;
+  if (!always && !ARMCII_GLOBAL_STATE.iov_checks) return 0;
 
   for (i = 0; i < count; i++) {
+    const int size_1 = (sizes != NULL) ? sizes[i] : size;
+
+    if (size_1 == 0) continue;
+
     for (j = i+1; j < count; j++) {
+      const int size_2 = (sizes != NULL) ? sizes[j] : size;
       const uint8_t *ptr_1_lo = ptrs[i];
-      const uint8_t *ptr_1_hi = ((uint8_t*)ptrs[i]) + size - 1;
+      const uint8_t *ptr_1_hi = ((uint8_t*)ptrs[i]) + size_1 - 1;
       const uint8_t *ptr_2_lo = ptrs[j];
-      const uint8_t *ptr_2_hi = ((uint8_t*)ptrs[j]) + size - 1;
+      const uint8_t *ptr_2_hi = ((uint8_t*)ptrs[j]) + size_2 - 1;
+
+      if (size_2 == 0) continue;
 
       if (   (ptr_1_lo >= ptr_2_lo && ptr_1_lo <= ptr_2_hi)
           || (ptr_1_hi >= ptr_2_lo && ptr_1_hi <= ptr_2_hi)
@@ -45,26 +122,46 @@ int ARMCII_Iov_check_overlap(void **ptrs, int count, int size) {
     }
   }
 #else
-  int i;
-  ctree_t ctree = CTREE_EMPTY;
+  armcii_iov_range_t *ranges, *tmp, *sorted;
+  int i, n, sorted_in = 1, conflict = 0;
 
-  if (!ARMCII_GLOBAL_STATE.iov_checks) return 0;
+  if (!always && !ARMCII_GLOBAL_STATE.iov_checks) return 0;
 
-  for (i = 0; i < count; i++) {
-    int conflict = ctree_insert(&ctree, ptrs[i], ((uint8_t*)ptrs[i]) + size - 1);
+  ranges = ARMCII_Arena_alloc(2*(size_t)count*sizeof(armcii_iov_range_t));
+  tmp    = &ranges[count];
 
-    if (conflict) {
-      ctree_t cnode = ctree_locate(ctree, ptrs[i], ((uint8_t*)ptrs[i]) + size - 1);
+  for (i = n = 0; i < count; i++) {
+    const int seg_size = (sizes != NULL) ? sizes[i] : size;
 
-      ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV regions overlap: [%p, %p] - [%p, %p]\n",
-          ptrs[i], ((uint8_t*)ptrs[i]) + size - 1, cnode->lo, cnode->hi);
+    if (seg_size == 0) continue;
 
-      ctree_destroy(&ctree);
-      return 1;
+    ranges[n].lo = (uintptr_t) ptrs[i];
+    ranges[n].hi = (uintptr_t) ptrs[i] + seg_size - 1;
+
+    if (n > 0 && ranges[n].lo < ranges[n-1].lo)
+      sorted_in = 0;
+
+    n++;
+  }
+
+  /* Vectors are usually generated in address order */
+  sorted = sorted_in ? ranges : ARMCII_Iov_sort_ranges(ranges, tmp, n);
+
+  /* Sorted by low address, the ranges are disjoint iff each one starts after
+   * the previous one ends. */
+  for (i = 1; i < n; i++) {
+    if (sorted[i].lo <= sorted[i-1].hi) {
+      ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV regions overlap: [%p, %p] - [%p, %p]\n",
+          (void*) sorted[i-1].lo, (void*) sorted[i-1].hi, (void*) sorted[i].lo, (void*) sorted[i].hi);
+      conflict = 1;
+      break;
     }
   }
 
-  ctree_destroy(&ctree);
+  ARMCII_Arena_free(ranges);
+
+  if (conflict)
+    return 1;
 #endif /* NO_USE_CTREE */
 #endif /* NO_CHECK_OVERLAP */
 
@@ -72,6 +169,42 @@ int ARMCII_Iov_check_overlap(void **ptrs, int count, int size) {
 }
 
 
+/** Check an I/O vector operation's buffers for overlap.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @return             Logical true when regions overlap, 0 otherwise.
+  */
+int ARMCII_Iov_check_overlap(void **ptrs, int count, int size) {
+  return ARMCII_Iov_check_overlap_core(ptrs, count, size, NULL, 0);
+}
+
+
+/** Check a variable-length I/O vector operation's buffers for overlap.
+  *
+  * @param[in] ptrs     Array of buffer pointers.
+  * @param[in] count    Length of the ptrs array.
+  * @param[in] sizes    Size of each buffer in bytes.
+  * @return             Logical true when regions overlap, 0 otherwise.
+  */
+int ARMCII_Iov_check_overlap_vl(void **ptrs, int count, const int *sizes) {
+  return ARMCII_Iov_check_overlap_core(ptrs, count, 0, sizes, 0);
+}
+
+
+/** Check buffers for overlap even when ARMCI_IOV_CHECKS is disabled, for
+  * vectors that ARMCI-MPI assembles itself rather than receiving from the user.
+  *
+  * @param[in] ptrs     Array of buffer pointers.
+  * @param[in] count    Length of the ptrs array.
+  * @param[in] size     Size of each buffer in bytes, when sizes is NULL.
+  * @param[in] sizes    Size of each buffer in bytes, or NULL.
+  * @return             Logical true when regions overlap, 0 otherwise.
+  */
+int ARMCII_Iov_check_overlap_always(void **ptrs, int count, int size, const int *sizes) {
+  return ARMCII_Iov_check_overlap_core(ptrs, count, size, sizes, 1);
+}
+
+
 /** Check if a set of pointers all corresponds to the same allocation.
   *
   * @param[in] ptrs  An array of count shared pointers valid on proc.
@@ -110,26 +243,413 @@ int ARMCII_Iov_check_same_allocation(void **ptrs, int count, int proc) {
 }
 
 
-/** Perform an I/O vector operation.  Local buffers must be private.
+/** A segment of an I/O vector, used when sorting segments by remote address.
+  */
+typedef struct {
+  void *loc;
+  void *rem;
+} armcii_iov_seg_t;
+
+static int ARMCII_Iov_seg_cmp(const void *a, const void *b) {
+  const uintptr_t rem_a = (uintptr_t) ((const armcii_iov_seg_t*)a)->rem;
+  const uintptr_t rem_b = (uintptr_t) ((const armcii_iov_seg_t*)b)->rem;
+
+  return (rem_a > rem_b) - (rem_a < rem_b);
+}
+
+
+/** Coalesce the segments of an I/O vector.  Segments are sorted by remote
+  * address, then runs that are contiguous at both the origin and the target
+  * are merged into variable-length blocks.  Reordering is only safe when the
+  * remote regions do not overlap.
   *
-  * @param[in] op          Operation to be performed (ARMCII_OP_PUT, ...)
-  * @param[in] src         Array of source pointers
-  * @param[in] dst         Array of destination pointers
-  * @param[in] count       Length of pointer arrays
-  * @param[in] size        Size of each transfer
-  * @param[in] datatype    Data type for accumulate op (ignored for all others)
-  * @param[in] overlapping Do remote regions overlap?
-  * @param[in] same_alloc  Do remote regions correspond to the same allocation?
-  * @param[in] proc        Target process
-  * @return                Zero on success, error code otherwise
+  * @param[in]  loc      Array of local pointers
+  * @param[in]  rem      Array of remote pointers
+  * @param[in]  count    Length of pointer arrays
+  * @param[in]  size     Size of each segment in bytes
+  * @param[out] loc_out  Local address of each block (count entries)
+  * @param[out] rem_out  Remote address of each block (count entries)
+  * @param[out] len_out  Length of each block in bytes (count entries)
+  * @return              Number of blocks
   */
-int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
-                           int datatype, int overlapping, int same_alloc, int proc,
-                           int blocking, armci_hdl_t * handle)
+int ARMCII_Iov_coalesce(void **loc, void **rem, int count, int size,
+                        void **loc_out, void **rem_out, int *len_out) {
+  armcii_iov_seg_t *segs;
+  int i, sorted, nblk;
+
+  segs = ARMCII_Arena_alloc(count*sizeof(armcii_iov_seg_t));
+
+  for (i = 0, sorted = 1; i < count; i++) {
+    segs[i].loc = loc[i];
+    segs[i].rem = rem[i];
+
+    if (i > 0 && (uintptr_t) rem[i] < (uintptr_t) rem[i-1])
+      sorted = 0;
+  }
+
+  /* Vectors generated from patches are usually already in remote order */
+  if (!sorted)
+    qsort(segs, count, sizeof(armcii_iov_seg_t), ARMCII_Iov_seg_cmp);
+
+  loc_out[0] = segs[0].loc;
+  rem_out[0] = segs[0].rem;
+  len_out[0] = size;
+
+  for (i = 1, nblk = 0; i < count; i++) {
+    if (   ((uint8_t*)loc_out[nblk]) + len_out[nblk] == (uint8_t*)segs[i].loc
+        && ((uint8_t*)rem_out[nblk]) + len_out[nblk] == (uint8_t*)segs[i].rem
+        && len_out[nblk] <= INT_MAX - size)
+    {
+      len_out[nblk] += size;
+    } else {
+      nblk++;
+      loc_out[nblk] = segs[i].loc;
+      rem_out[nblk] = segs[i].rem;
+      len_out[nblk] = size;
+    }
+  }
+
+  ARMCII_Arena_free(segs);
+
+  ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV coalesced %d segments into %d blocks\n", count, nblk+1);
+
+  return nblk+1;
+}
+
+
+/** Detect a regular access pattern in an I/O vector.  A vector is regular
+  * when consecutive segments are a constant distance apart at both the origin
+  * and the target (one level), or when it is made of equally spaced rows of
+  * such segments (two levels), as produced by flattening a 2-D patch.  Only
+  * increasing, non-overlapping patterns are reported.  This check is O(count).
+  *
+  * @param[in]  loc      Array of local pointers
+  * @param[in]  rem      Array of remote pointers
+  * @param[in]  count    Length of pointer arrays
+  * @param[in]  size     Size of each segment in bytes
+  * @param[out] pat      Description of the pattern
+  * @return              Nonzero if the vector is regular
+  */
+int ARMCII_Iov_find_pattern(void **loc, void **rem, int count, int size, armcii_iov_pattern_t *pat) {
+  MPI_Aint d_loc, d_rem, row_loc, row_rem;
+  int i, inner;
+
+  if (count < 2)
+    return 0;
+
+  d_loc = ((uint8_t*)loc[1]) - ((uint8_t*)loc[0]);
+  d_rem = ((uint8_t*)rem[1]) - ((uint8_t*)rem[0]);
+
+  if (d_loc < size || d_rem < size)
+    return 0;
+
+  /* Length of the first row of equally spaced segments */
+  for (inner = 2; inner < count; inner++) {
+    if (   ((uint8_t*)loc[inner]) - ((uint8_t*)loc[inner-1]) != d_loc
+        || ((uint8_t*)rem[inner]) - ((uint8_t*)rem[inner-1]) != d_rem)
+      break;
+  }
+
+  pat->inner         = inner;
+  pat->outer         = count/inner;
+  pat->loc_stride[0] = d_loc;
+  pat->rem_stride[0] = d_rem;
+
+  if (inner == count) {
+    pat->levels        = 1;
+    pat->loc_stride[1] = 0;
+    pat->rem_stride[1] = 0;
+    return 1;
+  }
+
+  if (count % inner != 0)
+    return 0;
+
+  row_loc = ((uint8_t*)loc[inner]) - ((uint8_t*)loc[0]);
+  row_rem = ((uint8_t*)rem[inner]) - ((uint8_t*)rem[0]);
+
+  /* Rows must not overlap each other */
+  if (   row_loc < (inner-1)*d_loc + size
+      || row_rem < (inner-1)*d_rem + size)
+    return 0;
+
+  for (i = inner; i < count; i++) {
+    const MPI_Aint off_loc = (i/inner)*row_loc + (i%inner)*d_loc;
+    const MPI_Aint off_rem = (i/inner)*row_rem + (i%inner)*d_rem;
+
+    if (   ((uint8_t*)loc[i]) - ((uint8_t*)loc[0]) != off_loc
+        || ((uint8_t*)rem[i]) - ((uint8_t*)rem[0]) != off_rem)
+      return 0;
+  }
+
+  pat->levels        = 2;
+  pat->loc_stride[1] = row_loc;
+  pat->rem_stride[1] = row_rem;
+
+  return 1;
+}
+
+
+/** Build the datatype for one side of a regular I/O vector.
+  */
+static void ARMCII_Iov_pattern_to_dtype(armcii_iov_pattern_t *pat, MPI_Aint stride[2], int elem_count,
+                                        MPI_Datatype type, MPI_Datatype *new_type) {
+  MPI_Datatype row_type;
+
+  if (pat->levels == 1) {
+    MPI_Type_create_hvector(pat->inner, elem_count, stride[0], type, new_type);
+  } else {
+    MPI_Type_create_hvector(pat->inner, elem_count, stride[0], type, &row_type);
+    MPI_Type_create_hvector(pat->outer, 1, stride[1], row_type, new_type);
+    MPI_Type_free(&row_type);
+  }
+
+  MPI_Type_commit(new_type);
+}
+
+
+/** Implementation of the ARMCI IOV operation for regular vectors.  The
+  * transfer is issued as a single operation with vector datatypes on both
+  * sides, so no per-segment displacements are needed.
+  */
+int ARMCII_Iov_op_pattern(enum ARMCII_Op_e op, void *loc, void *rem, armcii_iov_pattern_t *pat,
+                          int elem_count, MPI_Datatype type, int proc, int blocking, armci_hdl_t *handle) {
+  gmr_t *mreg;
+  MPI_Datatype type_loc, type_rem;
+  int flush_local = 1;
+
+  mreg = gmr_lookup(rem, proc);
+  ARMCII_Assert_msg(mreg != NULL, "Invalid remote pointer");
+
+  ARMCII_Iov_pattern_to_dtype(pat, pat->loc_stride, elem_count, type, &type_loc);
+  ARMCII_Iov_pattern_to_dtype(pat, pat->rem_stride, elem_count, type, &type_rem);
+
+  switch(op) {
+    case ARMCII_OP_PUT:
+      gmr_put_typed(mreg, loc, 1, type_loc, rem, 1, type_rem, proc, handle);
+      flush_local = 1;
+      break;
+    case ARMCII_OP_GET:
+      gmr_get_typed(mreg, rem, 1, type_rem, loc, 1, type_loc, proc, handle);
+      flush_local = 0;
+      break;
+    case ARMCII_OP_ACC:
+      gmr_accumulate_typed(mreg, loc, 1, type_loc, rem, 1, type_rem, proc, handle);
+      flush_local = 1;
+      break;
+    default:
+      ARMCII_Error("unknown operation (%d)", op);
+      return 1;
+  }
+
+  MPI_Type_free(&type_loc);
+  MPI_Type_free(&type_rem);
+
+  if (blocking) {
+    gmr_flush(mreg, proc, flush_local);
+  }
+
+  return 0;
+}
+
+
+/** Perform an I/O vector operation whose remote buffers all fall within a
+  * single allocation, using the optimized (pattern, datatype or batched)
+  * methods.  Segments have type_count elements each, unless seg_counts is
+  * given, in which case segment i has seg_counts[i] elements.
+  */
+static int ARMCII_Iov_op_window(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
+                                int *seg_counts, MPI_Datatype type, int type_count, int type_size,
+                                int proc, int blocking, armci_hdl_t * handle)
+{
+  void **blk_src = src, **blk_dst = dst, **blk_ptrs = NULL;
+  int   *blk_counts = NULL;
+  int    i, nblk = count, err;
+  armcii_iov_pattern_t pat;
+
+  /* Variable-length segments go straight to the engines, which build indexed
+   * types (or issue one operation per segment) from the per-segment counts. */
+  if (seg_counts != NULL) {
+    if (   ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_DIRECT
+        || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_AUTO  )
+      return ARMCII_Iov_op_datatype(op, src, dst, count, 0, seg_counts, type, proc, blocking, handle);
+    else
+      return ARMCII_Iov_op_batched(op, src, dst, count, 0, seg_counts, type, proc, 0 /* not consrv */, blocking, handle);
+  }
+
+  /* Regular vectors (e.g. a flattened 2-D patch) are really strided
+   * transfers; send them with vector datatypes when the strided method
+   * allows datatypes. */
+  if (ARMCII_GLOBAL_STATE.strided_method == ARMCII_STRIDED_DIRECT) {
+    void **loc = (op == ARMCII_OP_GET) ? dst : src;
+    void **rem = (op == ARMCII_OP_GET) ? src : dst;
+
+    if (ARMCII_Iov_find_pattern(loc, rem, count, size, &pat)) {
+      ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV is regular: %d level(s), %d x %d segments\n",
+                       pat.levels, pat.outer, pat.inner);
+      return ARMCII_Iov_op_pattern(op, loc[0], rem[0], &pat, type_count, type, proc, blocking, handle);
+    }
+  }
+
+  /* Merge segments that are contiguous at both ends into larger blocks.  The
+   * remote regions don't overlap, so the segments can be reordered. */
+  if (ARMCII_GLOBAL_STATE.iov_coalesce && count > 1) {
+    void **blk_loc, **blk_rem;
+
+    blk_ptrs   = ARMCII_Arena_alloc(2*count*sizeof(void*));
+    blk_counts = ARMCII_Arena_alloc(count*sizeof(int));
+
+    blk_loc = &blk_ptrs[0];
+    blk_rem = &blk_ptrs[count];
+
+    if (op == ARMCII_OP_GET) {
+      nblk    = ARMCII_Iov_coalesce(dst, src, count, size, blk_loc, blk_rem, blk_counts);
+      blk_src = blk_rem;
+      blk_dst = blk_loc;
+    } else {
+      nblk    = ARMCII_Iov_coalesce(src, dst, count, size, blk_loc, blk_rem, blk_counts);
+      blk_src = blk_loc;
+      blk_dst = blk_rem;
+    }
+
+    for (i = 0; i < nblk; i++)
+      blk_counts[i] /= type_size;
+  }
+
+  /* Nothing merged: every block still has the same length */
+  if (nblk == count) {
+    ARMCII_Arena_free(blk_counts);
+    blk_counts = NULL;
+  }
+
+  if (   ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_DIRECT
+      || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_AUTO  ) {
+    err = ARMCII_Iov_op_datatype(op, blk_src, blk_dst, nblk, type_count, blk_counts, type, proc, blocking, handle);
+
+  } else if (ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_BATCHED) {
+    err = ARMCII_Iov_op_batched(op, blk_src, blk_dst, nblk, type_count, blk_counts, type, proc, 0 /* not consrv */, blocking, handle);
+
+  } else {
+    ARMCII_Error("unknown iov method (%d)\n", ARMCII_GLOBAL_STATE.iov_method);
+    err = 1;
+  }
+
+  ARMCII_Arena_free(blk_counts);
+  ARMCII_Arena_free(blk_ptrs);
+
+  return err;
+}
+
+
+/** Perform an I/O vector operation whose remote buffers span several
+  * allocations.  Segments are grouped by the GMR that owns their remote
+  * buffer and each group is issued as an optimized, nonblocking operation on
+  * that GMR's window.  When blocking, each touched window is flushed once at
+  * the end.  Remote regions must not overlap.
+  */
+static int ARMCII_Iov_op_multi_window(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
+                                      int *seg_counts, MPI_Datatype type, int type_count, int type_size,
+                                      int proc, int blocking, armci_hdl_t * handle)
+{
+  gmr_t **wins, *last = NULL;
+  void  **rem, **grp_ptrs, **grp_src, **grp_dst;
+  int    *seg_win, *grp_off, *grp_counts = NULL;
+  int     i, w, nwin = 0, last_win = -1, err = 0;
+
+  rem = (op == ARMCII_OP_GET) ? src : dst;
+
+  seg_win  = ARMCII_Arena_alloc(count*sizeof(int));
+  grp_off  = ARMCII_Arena_alloc((count+1)*sizeof(int));
+  wins     = ARMCII_Arena_alloc(count*sizeof(gmr_t*));
+  grp_ptrs = ARMCII_Arena_alloc(2*count*sizeof(void*));
+
+  if (seg_counts != NULL)
+    grp_counts = ARMCII_Arena_alloc(count*sizeof(int));
+
+  /* Find the owning GMR of each segment.  Consecutive segments usually hit the
+   * same GMR, so check the previous one before searching. */
+  for (i = 0; i < count; i++) {
+    if (last != NULL) {
+      const uint8_t *base = last->slices[proc].base;
+
+      if ((uint8_t*) rem[i] >= base && (uint8_t*) rem[i] < base + last->slices[proc].size) {
+        seg_win[i] = last_win;
+        continue;
+      }
+    }
+
+    last = gmr_lookup(rem[i], proc);
+    ARMCII_Assert_msg(last != NULL, "Invalid remote pointer");
+
+    for (w = 0; w < nwin && wins[w] != last; w++)
+      ;
+
+    if (w == nwin)
+      wins[nwin++] = last;
+
+    seg_win[i] = last_win = w;
+  }
+
+  ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV spans %d windows\n", nwin);
+
+  /* Stable counting sort of the segments by window */
+  for (w = 0; w <= nwin; w++)
+    grp_off[w] = 0;
+
+  for (i = 0; i < count; i++)
+    grp_off[seg_win[i]+1]++;
+
+  for (w = 0; w < nwin; w++)
+    grp_off[w+1] += grp_off[w];
+
+  grp_src = &grp_ptrs[0];
+  grp_dst = &grp_ptrs[count];
+
+  for (i = 0; i < count; i++) {
+    const int pos = grp_off[seg_win[i]]++;
+
+    grp_src[pos] = src[i];
+    grp_dst[pos] = dst[i];
+
+    if (seg_counts != NULL)
+      grp_counts[pos] = seg_counts[i];
+  }
+
+  /* grp_off[w] now holds the end of group w */
+  for (w = 0; w < nwin && !err; w++) {
+    const int first = (w == 0) ? 0 : grp_off[w-1];
+
+    err = ARMCII_Iov_op_window(op, &grp_src[first], &grp_dst[first], grp_off[w] - first, size,
+                               (grp_counts != NULL) ? &grp_counts[first] : NULL,
+                               type, type_count, type_size, proc, 0 /* nonblocking */, handle);
+  }
+
+  if (blocking) {
+    for (w = 0; w < nwin; w++)
+      gmr_flush(wins[w], proc, op != ARMCII_OP_GET);
+  }
+
+  ARMCII_Arena_free(grp_counts);
+  ARMCII_Arena_free(grp_ptrs);
+  ARMCII_Arena_free(wins);
+  ARMCII_Arena_free(grp_off);
+  ARMCII_Arena_free(seg_win);
+
+  return err;
+}
+
+
+/** Perform an I/O vector operation whose segments are all size bytes long,
+  * or sizes[i] bytes long when sizes is given.
+  */
+static int ARMCII_Iov_op_dispatch_core(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
+                                       const int *sizes, int datatype, int overlapping, int same_alloc,
+                                       int proc, int blocking, armci_hdl_t * handle)
 {
 
   MPI_Datatype type;
-  int type_count, type_size;
+  int type_count = 0, type_size, err;
+  int *seg_counts = NULL;
 
   if (op == ARMCII_OP_ACC) {
     ARMCII_Acc_type_translate(datatype, &type, &type_size);
@@ -137,38 +657,112 @@ int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int coun
     type = MPI_BYTE;
     MPI_Type_size(type, &type_size);
   }
-  type_count = size/type_size;
-  ARMCII_Assert_msg(size % type_size == 0, "Transfer size is not a multiple of type size");
 
-  // CONSERVATIVE CASE: If remote pointers overlap or remote pointers correspond to
-  // multiple allocations, use the safe implementation to avoid invalid MPI
-  // use.
+  if (sizes != NULL) {
+    int i;
+
+    seg_counts = ARMCII_Arena_alloc(count*sizeof(int));
+
+    for (i = 0; i < count; i++) {
+      ARMCII_Assert_msg(sizes[i] >= 0 && sizes[i] % type_size == 0, "Transfer size is not a multiple of type size");
+      seg_counts[i] = sizes[i]/type_size;
+    }
+  } else {
+    type_count = size/type_size;
+    ARMCII_Assert_msg(size % type_size == 0, "Transfer size is not a multiple of type size");
+  }
+
+  // ORDERED CASE: Overlapping accumulates (and puts, when they are performed
+  // as accumulates) into one window are applied in order when the window was
+  // created with write-after-write accumulate ordering, so they can be issued
+  // back-to-back and completed with a single flush.
+
+  if (   overlapping && same_alloc
+      && ARMCII_GLOBAL_STATE.iov_method != ARMCII_IOV_CONSRV
+      && ARMCII_GLOBAL_STATE.rma_ordered_waw
+      && (op == ARMCII_OP_ACC || (op == ARMCII_OP_PUT && ARMCII_GLOBAL_STATE.rma_atomicity)))
+  {
+    ARMCII_Dbg_print(DEBUG_CAT_IOV, "IOV remote buffers overlap, relying on accumulate ordering\n");
+    err = ARMCII_Iov_op_batched(op, src, dst, count, type_count, seg_counts, type, proc, 0 /* not consrv */, blocking, handle);
+  }
+
+  // CONSERVATIVE CASE: If remote pointers overlap, use the safe implementation
+  // to avoid invalid MPI use.
 
-  if (overlapping || !same_alloc || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_CONSRV) {
+  else if (overlapping || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_CONSRV) {
     if (overlapping) ARMCII_Warning("IOV remote buffers overlap\n");
-    if (!same_alloc) ARMCII_Warning("IOV remote buffers are not within the same allocation\n");
 #if 0
-    return ARMCII_Iov_op_safe(op, src, dst, count, type_count, type, proc);
+    err = ARMCII_Iov_op_safe(op, src, dst, count, type_count, type, proc);
 #else
     /* Jeff: We are going to always block when there is buffer overlap. */
-    return ARMCII_Iov_op_batched(op, src, dst, count, type_count, type, proc, 1 /* consrv */, 1 /* blocking */, handle);
+    err = ARMCII_Iov_op_batched(op, src, dst, count, type_count, seg_counts, type, proc, 1 /* consrv */, 1 /* blocking */, handle);
 #endif
   }
 
+  // MULTIPLE ALLOCATIONS: Split the vector by window and issue the pieces
+  // concurrently, with one flush per window.
+
+  else if (!same_alloc) {
+    err = ARMCII_Iov_op_multi_window(op, src, dst, count, size, seg_counts, type, type_count, type_size,
+                                     proc, blocking, handle);
+  }
+
   // OPTIMIZED CASE: It's safe for us to issue all the operations under a
   // single lock.
 
-  else if (   ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_DIRECT
-           || ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_AUTO  ) {
-    return ARMCII_Iov_op_datatype(op, src, dst, count, type_count, type, proc, blocking, handle);
+  else {
+    err = ARMCII_Iov_op_window(op, src, dst, count, size, seg_counts, type, type_count, type_size,
+                               proc, blocking, handle);
+  }
 
-  } else if (ARMCII_GLOBAL_STATE.iov_method == ARMCII_IOV_BATCHED) {
-    return ARMCII_Iov_op_batched(op, src, dst, count, type_count, type, proc, 0 /* not consrv */, blocking, handle);
+  ARMCII_Arena_free(seg_counts);
 
-  } else {
-    ARMCII_Error("unknown iov method (%d)\n", ARMCII_GLOBAL_STATE.iov_method);
-    return 1;
-  }
+  return err;
+}
+
+
+/** Perform an I/O vector operation.  Local buffers must be private.
+  *
+  * @param[in] op          Operation to be performed (ARMCII_OP_PUT, ...)
+  * @param[in] src         Array of source pointers
+  * @param[in] dst         Array of destination pointers
+  * @param[in] count       Length of pointer arrays
+  * @param[in] size        Size of each transfer
+  * @param[in] datatype    Data type for accumulate op (ignored for all others)
+  * @param[in] overlapping Do remote regions overlap?
+  * @param[in] same_alloc  Do remote regions correspond to the same allocation?
+  * @param[in] proc        Target process
+  * @return                Zero on success, error code otherwise
+  */
+int ARMCII_Iov_op_dispatch(enum ARMCII_Op_e op, void **src, void **dst, int count, int size,
+                           int datatype, int overlapping, int same_alloc, int proc,
+                           int blocking, armci_hdl_t * handle)
+{
+  return ARMCII_Iov_op_dispatch_core(op, src, dst, count, size, NULL, datatype, overlapping,
+                                     same_alloc, proc, blocking, handle);
+}
+
+
+/** Perform a variable-length I/O vector operation.  Local buffers must be
+  * private.
+  *
+  * @param[in] op          Operation to be performed (ARMCII_OP_PUT, ...)
+  * @param[in] src         Array of source pointers
+  * @param[in] dst         Array of destination pointers
+  * @param[in] count       Length of pointer arrays
+  * @param[in] sizes       Size of each transfer
+  * @param[in] datatype    Data type for accumulate op (ignored for all others)
+  * @param[in] overlapping Do remote regions overlap?
+  * @param[in] same_alloc  Do remote regions correspond to the same allocation?
+  * @param[in] proc        Target process
+  * @return                Zero on success, error code otherwise
+  */
+int ARMCII_Iov_op_dispatch_vl(enum ARMCII_Op_e op, void **src, void **dst, int count, const int *sizes,
+                              int datatype, int overlapping, int same_alloc, int proc,
+                              int blocking, armci_hdl_t * handle)
+{
+  return ARMCII_Iov_op_dispatch_core(op, src, dst, count, 0, sizes, datatype, overlapping,
+                                     same_alloc, proc, blocking, handle);
 }
 
 #if 0
@@ -226,10 +820,11 @@ int ARMCII_Iov_op_safe(enum ARMCII_Op_e op, void **src, void **dst, int count, i
 #endif
 
 /** Optimized implementation of the ARMCI IOV operation that uses a single
-  * lock/unlock pair.
+  * lock/unlock pair.  Each segment has elem_count elements, unless blk_counts
+  * is given, in which case segment i has blk_counts[i] elements.
   */
 int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
-    MPI_Datatype type, int proc, int consrv, int blocking, armci_hdl_t * handle) {
+    int *blk_counts, MPI_Datatype type, int proc, int consrv, int blocking, armci_hdl_t * handle) {
 
   int i;
   int flush_local = 1; /* used only for MPI-3 */
@@ -263,6 +858,9 @@ int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count
       gmr_flush(mreg, proc, flush_local);
     }
 
+    if (blk_counts != NULL)
+      elem_count = blk_counts[i];
+
     switch(op) {
       case ARMCII_OP_PUT:
         gmr_put(mreg, src[i], dst[i], elem_count, proc, handle);
@@ -291,22 +889,21 @@ int ARMCII_Iov_op_batched(enum ARMCII_Op_e op, void **src, void **dst, int count
 
 
 /** Optimized implementation of the ARMCI IOV operation that uses an MPI
-  * datatype to achieve a one-sided gather/scatter.
+  * datatype to achieve a one-sided gather/scatter.  Each segment has
+  * elem_count elements, unless blk_counts is given, in which case segment i
+  * has blk_counts[i] elements.
   */
 int ARMCII_Iov_op_datatype(enum ARMCII_Op_e op, void **src, void **dst, int count, int elem_count,
-                           MPI_Datatype type, int proc, int blocking, armci_hdl_t * handle)
+                           int *blk_counts, MPI_Datatype type, int proc, int blocking, armci_hdl_t * handle)
 {
 
     gmr_t *mreg;
     MPI_Datatype  type_loc, type_rem;
-    int           disp_loc[count];
-    int           disp_rem[count];
-    int           block_len[count];
-    MPI_Aint      loc_addr[count];
-    MPI_Aint      base_loc;
-    void         *base_loc_ptr;
+    int          *disp_loc, *disp_rem, *block_len;
+    MPI_Aint     *loc_addr;
+    void         *scratch;
     void         *dst_win_base;
-    int           dst_win_size, i, type_size;
+    int           dst_win_size, i, type_size, chunk, start;
     void        **buf_rem, **buf_loc;
     MPI_Aint      base_rem;
     int flush_local = 0; /* used only for MPI-3 */
@@ -336,54 +933,76 @@ int ARMCII_Iov_op_datatype(enum ARMCII_Op_e op, void **src, void **dst, int coun
 
     MPI_Get_address(dst_win_base, &base_rem);
 
-    /* Build both origin and target as element-indexed (indexed_block) types relative to a
-     * real base buffer, instead of absolute-address hindexed types used from MPI_BOTTOM:
-     * osc/ucx (OMPI4/OMPI5) segfaults when handed an hindexed/MPI_BOTTOM origin datatype in
-     * Accumulate, and an absolute-address target descriptor is large enough to overflow the
-     * ch4:ucx (MPICH) active-message header.  The origin is based at the LOWEST local
-     * segment address so element displacements are non-negative -- the segments are not
-     * necessarily in address order (e.g. the scaled-copy source buffers for ACC).
-     *
-     * indexed_block displacements are 32-bit element offsets.  For a scaled/guarded ACC each
-     * origin segment is a separate MPI_Alloc_mem allocation (ARMCII_Buf_prepare_acc_vec) and
-     * can be arbitrarily far from the base, so assert the element offset fits in a 32-bit int
-     * rather than silently truncating it into a wild address. */
-    base_loc_ptr = buf_loc[0];
-    MPI_Get_address(buf_loc[0], &base_loc);
-    for (i = 0; i < count; i++) {
-      MPI_Get_address(buf_loc[i], &loc_addr[i]);
-      if (loc_addr[i] < base_loc) { base_loc = loc_addr[i]; base_loc_ptr = buf_loc[i]; }
-    }
-
-    for (i = 0; i < count; i++) {
-      MPI_Aint target_rem, off_loc;
-      MPI_Get_address(buf_rem[i], &target_rem);
-      off_loc      = (loc_addr[i] - base_loc)/type_size;  /* element offset from base (>= 0) */
-      disp_rem[i]  = (target_rem - base_rem)/type_size;    /* element offset within the window */
-      block_len[i] = elem_count;
-
-      ARMCII_Assert_msg((loc_addr[i] - base_loc) % type_size == 0, "Local transfer offset is not a multiple of type size");
-      ARMCII_Assert_msg(off_loc <= INT_MAX, "Local segment span exceeds 32-bit element displacement; use ARMCI_IOV_METHOD=BATCHED");
-      ARMCII_Assert_msg((target_rem - base_rem) % type_size == 0, "Transfer size is not a multiple of type size");
-      ARMCII_Assert_msg(disp_rem[i] >= 0 && disp_rem[i] < dst_win_size, "Invalid remote pointer");
-      ARMCII_Assert_msg(((uint8_t*)buf_rem[i]) + block_len[i] <= ((uint8_t*)dst_win_base) + dst_win_size, "Transfer exceeds buffer length");
-      disp_loc[i]  = (int)off_loc;
-    }
-
     /* Optionally chunk the blocks across several ops so the flattened datatype
      * descriptor stays small.  chunk == 0 means one op over all blocks. */
-    int chunk = ARMCII_GLOBAL_STATE.iov_dtype_chunk;
+    chunk = ARMCII_GLOBAL_STATE.iov_dtype_chunk;
     if (chunk <= 0 || chunk > count) chunk = count;
 
-    for (int start = 0; start < count; start += chunk) {
-      int n = (count - start < chunk) ? (count - start) : chunk;
+    /* Displacements are built one chunk at a time in a per-thread scratch area
+     * that is reused by every chunk.  MPI copies the displacements when the
+     * type is created, so chunk k is in flight while chunk k+1 is built. */
+    scratch = ARMCII_Arena_alloc((size_t)chunk*(3*sizeof(int) + sizeof(MPI_Aint)));
+
+    loc_addr  = (MPI_Aint*) scratch;
+    disp_loc  = (int*) &loc_addr[chunk];
+    disp_rem  = &disp_loc[chunk];
+    block_len = &disp_rem[chunk];
+
+    for (start = 0; start < count; start += chunk) {
+      int       n = (count - start < chunk) ? (count - start) : chunk;
+      MPI_Aint  base_loc;
+      void     *base_loc_ptr;
+
+      /* Build both origin and target as element-indexed (indexed_block) types relative to a
+       * real base buffer, instead of absolute-address hindexed types used from MPI_BOTTOM:
+       * osc/ucx (OMPI4/OMPI5) segfaults when handed an hindexed/MPI_BOTTOM origin datatype in
+       * Accumulate, and an absolute-address target descriptor is large enough to overflow the
+       * ch4:ucx (MPICH) active-message header.  The origin is based at the LOWEST local
+       * segment address of the chunk so element displacements are non-negative -- the
+       * segments are not necessarily in address order (e.g. the scaled-copy source buffers
+       * for ACC).
+       *
+       * indexed_block displacements are 32-bit element offsets.  For a guarded ACC some
+       * origin segments live in a staging allocation (ARMCII_Buf_prepare_acc_vec) while the
+       * rest stay in the user's buffers, so they can be arbitrarily far from the base; assert
+       * the element offset fits in a 32-bit int rather than silently truncating it into a
+       * wild address. */
+      base_loc_ptr = buf_loc[start];
+      MPI_Get_address(buf_loc[start], &base_loc);
+      for (i = 0; i < n; i++) {
+        MPI_Get_address(buf_loc[start+i], &loc_addr[i]);
+        if (loc_addr[i] < base_loc) { base_loc = loc_addr[i]; base_loc_ptr = buf_loc[start+i]; }
+      }
+
+      for (i = 0; i < n; i++) {
+        MPI_Aint target_rem, off_loc;
+        MPI_Get_address(buf_rem[start+i], &target_rem);
+        off_loc      = (loc_addr[i] - base_loc)/type_size;  /* element offset from base (>= 0) */
+        disp_rem[i]  = (target_rem - base_rem)/type_size;    /* element offset within the window */
+        block_len[i] = (blk_counts != NULL) ? blk_counts[start+i] : elem_count;
+
+        ARMCII_Assert_msg((loc_addr[i] - base_loc) % type_size == 0, "Local transfer offset is not a multiple of type size");
+        ARMCII_Assert_msg(off_loc <= INT_MAX, "Local segment span exceeds 32-bit element displacement; use ARMCI_IOV_METHOD=BATCHED");
+        ARMCII_Assert_msg((target_rem - base_rem) % type_size == 0, "Transfer size is not a multiple of type size");
+        ARMCII_Assert_msg(disp_rem[i] >= 0 && disp_rem[i] < dst_win_size, "Invalid remote pointer");
+        ARMCII_Assert_msg(((uint8_t*)buf_rem[start+i]) + (MPI_Aint)block_len[i]*type_size <= ((uint8_t*)dst_win_base) + dst_win_size, "Transfer exceeds buffer length");
+        disp_loc[i]  = (int)off_loc;
+      }
 
-      /* Both origin and target are element-indexed relative to a real base buffer. */
-      MPI_Type_create_indexed_block(n, elem_count, &disp_loc[start], type, &type_loc);
-      MPI_Type_create_indexed_block(n, elem_count, &disp_rem[start], type, &type_rem);
+      /* Both origin and target are element-indexed relative to a real base buffer.
+       * Coalesced blocks have varying lengths and need a general indexed type. */
+      if (blk_counts != NULL) {
+        MPI_Type_indexed(n, block_len, disp_loc, type, &type_loc);
+        MPI_Type_indexed(n, block_len, disp_rem, type, &type_rem);
+      } else {
+        MPI_Type_create_indexed_block(n, elem_count, disp_loc, type, &type_loc);
+        MPI_Type_create_indexed_block(n, elem_count, disp_rem, type, &type_rem);
+      }
       MPI_Type_commit(&type_loc);
       MPI_Type_commit(&type_rem);
 
+      /* Chunks are not completed individually; a single flush (or the handle)
+       * completes all of them below. */
       switch(op) {
         case ARMCII_OP_PUT:
           gmr_put_typed(mreg, base_loc_ptr, 1, type_loc, MPI_BOTTOM, 1, type_rem, proc, handle);
@@ -406,6 +1025,8 @@ int ARMCII_Iov_op_datatype(enum ARMCII_Op_e op, void **src, void **dst, int coun
       MPI_Type_free(&type_rem);
     }
 
+    ARMCII_Arena_free(scratch);
+
     if (blocking) {
       gmr_flush(mreg, proc, flush_local);
     }
@@ -446,7 +1067,7 @@ int PARMCI_PutV(armci_giov_t *iov, int iov_len, int proc)
     ARMCII_Buf_prepare_read_vec(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes);
     ARMCII_Iov_op_dispatch(ARMCII_OP_PUT, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes, 0,
                            overlapping, same_alloc, proc, 1 /* blocking */, NULL);
-    ARMCII_Buf_finish_read_vec(iov[v].src_ptr_array, src_buf, iov[v].ptr_array_len, iov[v].bytes);
+    ARMCII_Buf_finish_read_vec(src_buf, iov[v].ptr_array_len);
   }
 
   return 0;
@@ -525,7 +1146,94 @@ int PARMCI_AccV(int datatype, void *scale, armci_giov_t *iov, int iov_len, int p
     ARMCII_Buf_prepare_acc_vec(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes, datatype, scale);
     ARMCII_Iov_op_dispatch(ARMCII_OP_ACC, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes, datatype,
                            overlapping, same_alloc, proc, 1 /* blocking */, NULL);
-    ARMCII_Buf_finish_acc_vec(iov[v].src_ptr_array, src_buf, iov[v].ptr_array_len, iov[v].bytes);
+    ARMCII_Buf_finish_acc_vec(src_buf, iov[v].ptr_array_len);
+  }
+
+  return 0;
+}
+
+
+/** Variable-length I/O vector one-sided put.  Segment i of each descriptor is
+  * iov[v].bytes_array[i] bytes long.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @param[in] iov_len  Length of iov.
+  * @param[in] proc     Target process.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_PutVL(armcix_giovl_t *iov, int iov_len, int proc)
+{
+  for (int v = 0; v < iov_len; v++) {
+    void **src_buf;
+    int    overlapping, same_alloc;
+
+    if (iov[v].ptr_array_len == 0) continue; // NOP //
+
+    overlapping = ARMCII_Iov_check_overlap_vl(iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array);
+    same_alloc  = ARMCII_Iov_check_same_allocation(iov[v].dst_ptr_array, iov[v].ptr_array_len, proc);
+
+    ARMCII_Buf_prepare_read_vecl(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes_array);
+    ARMCII_Iov_op_dispatch_vl(ARMCII_OP_PUT, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array, 0,
+                              overlapping, same_alloc, proc, 1 /* blocking */, NULL);
+    ARMCII_Buf_finish_read_vec(src_buf, iov[v].ptr_array_len);
+  }
+
+  return 0;
+}
+
+
+/** Variable-length I/O vector one-sided get.  Segment i of each descriptor is
+  * iov[v].bytes_array[i] bytes long.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @param[in] iov_len  Length of iov.
+  * @param[in] proc     Target process.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_GetVL(armcix_giovl_t *iov, int iov_len, int proc)
+{
+  for (int v = 0; v < iov_len; v++) {
+    void **dst_buf;
+    int    overlapping, same_alloc;
+
+    if (iov[v].ptr_array_len == 0) continue; // NOP //
+
+    overlapping = ARMCII_Iov_check_overlap_vl(iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array);
+    same_alloc  = ARMCII_Iov_check_same_allocation(iov[v].src_ptr_array, iov[v].ptr_array_len, proc);
+
+    ARMCII_Buf_prepare_write_vecl(iov[v].dst_ptr_array, &dst_buf, iov[v].ptr_array_len, iov[v].bytes_array);
+    ARMCII_Iov_op_dispatch_vl(ARMCII_OP_GET, iov[v].src_ptr_array, dst_buf, iov[v].ptr_array_len, iov[v].bytes_array, 0,
+                              overlapping, same_alloc, proc, 1 /* blocking */, NULL);
+    ARMCII_Buf_finish_write_vecl(iov[v].dst_ptr_array, dst_buf, iov[v].ptr_array_len, iov[v].bytes_array);
+  }
+
+  return 0;
+}
+
+
+/** Variable-length I/O vector one-sided accumulate.  Segment i of each
+  * descriptor is iov[v].bytes_array[i] bytes long.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @param[in] iov_len  Length of iov.
+  * @param[in] proc     Target process.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_AccVL(int datatype, void *scale, armcix_giovl_t *iov, int iov_len, int proc)
+{
+  for (int v = 0; v < iov_len; v++) {
+    void **src_buf;
+    int    overlapping, same_alloc;
+
+    if (iov[v].ptr_array_len == 0) continue; // NOP //
+
+    overlapping = ARMCII_Iov_check_overlap_vl(iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array);
+    same_alloc  = ARMCII_Iov_check_same_allocation(iov[v].dst_ptr_array, iov[v].ptr_array_len, proc);
+
+    ARMCII_Buf_prepare_acc_vecl(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes_array, datatype, scale);
+    ARMCII_Iov_op_dispatch_vl(ARMCII_OP_ACC, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array, datatype,
+                              overlapping, same_alloc, proc, 1 /* blocking */, NULL);
+    ARMCII_Buf_finish_acc_vec(src_buf, iov[v].ptr_array_len);
   }
 
   return 0;
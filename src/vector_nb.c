@@ -48,7 +48,7 @@ int PARMCI_NbPutV(armci_giov_t *iov, int iov_len, int proc, armci_hdl_t* handle)
     ARMCII_Buf_prepare_read_vec(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes);
     ARMCII_Iov_op_dispatch(ARMCII_OP_PUT, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes, 0,
                            overlapping, same_alloc, proc, blocking, handle);
-    ARMCII_Buf_finish_read_vec(iov[v].src_ptr_array, src_buf, iov[v].ptr_array_len, iov[v].bytes);
+    ARMCII_Buf_finish_read_vec(src_buf, iov[v].ptr_array_len);
   }
 
   gmr_progress();
@@ -143,7 +143,123 @@ int PARMCI_NbAccV(int datatype, void *scale, armci_giov_t *iov, int iov_len, int
     ARMCII_Buf_prepare_acc_vec(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes, datatype, scale);
     ARMCII_Iov_op_dispatch(ARMCII_OP_ACC, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes, datatype,
                            overlapping, same_alloc, proc, blocking, handle);
-    ARMCII_Buf_finish_acc_vec(iov[v].src_ptr_array, src_buf, iov[v].ptr_array_len, iov[v].bytes);
+    ARMCII_Buf_finish_acc_vec(src_buf, iov[v].ptr_array_len);
+  }
+
+  gmr_progress();
+
+  return 0;
+}
+
+
+/** Nonblocking variable-length I/O vector one-sided put.  Segment i of each
+  * descriptor is iov[v].bytes_array[i] bytes long.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @param[in] iov_len  Length of iov.
+  * @param[in] proc     Target process.
+  * @param[in] handle   Nonblocking handle.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_NbPutVL(armcix_giovl_t *iov, int iov_len, int proc, armci_hdl_t* handle)
+{
+  int blocking = 0;
+
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
+      blocking = 1;
+  }
+
+  for (int v = 0; v < iov_len; v++) {
+    void **src_buf;
+    int    overlapping, same_alloc;
+
+    if (iov[v].ptr_array_len == 0) continue; // NOP //
+
+    overlapping = ARMCII_Iov_check_overlap_vl(iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array);
+    same_alloc  = ARMCII_Iov_check_same_allocation(iov[v].dst_ptr_array, iov[v].ptr_array_len, proc);
+
+    ARMCII_Buf_prepare_read_vecl(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes_array);
+    ARMCII_Iov_op_dispatch_vl(ARMCII_OP_PUT, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array, 0,
+                              overlapping, same_alloc, proc, blocking, handle);
+    ARMCII_Buf_finish_read_vec(src_buf, iov[v].ptr_array_len);
+  }
+
+  gmr_progress();
+
+  return 0;
+}
+
+
+/** Nonblocking variable-length I/O vector one-sided get.  Segment i of each
+  * descriptor is iov[v].bytes_array[i] bytes long.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @param[in] iov_len  Length of iov.
+  * @param[in] proc     Target process.
+  * @param[in] handle   Nonblocking handle.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_NbGetVL(armcix_giovl_t *iov, int iov_len, int proc, armci_hdl_t* handle)
+{
+  int blocking = 0;
+
+  if (ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD) {
+      blocking = 1;
+  }
+
+  for (int v = 0; v < iov_len; v++) {
+    void **dst_buf;
+    int    overlapping, same_alloc;
+
+    if (iov[v].ptr_array_len == 0) continue; // NOP //
+
+    overlapping = ARMCII_Iov_check_overlap_vl(iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array);
+    same_alloc  = ARMCII_Iov_check_same_allocation(iov[v].src_ptr_array, iov[v].ptr_array_len, proc);
+
+    ARMCII_Buf_prepare_write_vecl(iov[v].dst_ptr_array, &dst_buf, iov[v].ptr_array_len, iov[v].bytes_array);
+    ARMCII_Iov_op_dispatch_vl(ARMCII_OP_GET, iov[v].src_ptr_array, dst_buf, iov[v].ptr_array_len, iov[v].bytes_array, 0,
+                              overlapping, same_alloc, proc, blocking, handle);
+    ARMCII_Buf_finish_write_vecl(iov[v].dst_ptr_array, dst_buf, iov[v].ptr_array_len, iov[v].bytes_array);
+  }
+
+  gmr_progress();
+
+  return 0;
+}
+
+
+/** Nonblocking variable-length I/O vector one-sided accumulate.  Segment i of
+  * each descriptor is iov[v].bytes_array[i] bytes long.
+  *
+  * @param[in] iov      Vector of transfer information.
+  * @param[in] iov_len  Length of iov.
+  * @param[in] proc     Target process.
+  * @param[in] handle   Nonblocking handle.
+  * @return             Success 0, otherwise non-zero.
+  */
+int ARMCIX_NbAccVL(int datatype, void *scale, armcix_giovl_t *iov, int iov_len, int proc, armci_hdl_t* handle)
+{
+  int blocking = 0;
+
+  /* Scaled sources are staged in a temporary buffer that is freed below */
+  if (   ARMCII_GLOBAL_STATE.shr_buf_method != ARMCII_SHR_BUF_NOGUARD
+      || ARMCII_Buf_acc_is_scaled(datatype, scale)) {
+      blocking = 1;
+  }
+
+  for (int v = 0; v < iov_len; v++) {
+    void **src_buf;
+    int    overlapping, same_alloc;
+
+    if (iov[v].ptr_array_len == 0) continue; // NOP //
+
+    overlapping = ARMCII_Iov_check_overlap_vl(iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array);
+    same_alloc  = ARMCII_Iov_check_same_allocation(iov[v].dst_ptr_array, iov[v].ptr_array_len, proc);
+
+    ARMCII_Buf_prepare_acc_vecl(iov[v].src_ptr_array, &src_buf, iov[v].ptr_array_len, iov[v].bytes_array, datatype, scale);
+    ARMCII_Iov_op_dispatch_vl(ARMCII_OP_ACC, src_buf, iov[v].dst_ptr_array, iov[v].ptr_array_len, iov[v].bytes_array, datatype,
+                              overlapping, same_alloc, proc, blocking, handle);
+    ARMCII_Buf_finish_acc_vec(src_buf, iov[v].ptr_array_len);
   }
 
   gmr_progress();
@@ -19,15 +19,38 @@ check_PROGRAMS += tests/test_onesided         \
                   tests/test_malloc_group     \
                   tests/test_accs             \
                   tests/test_accs_dla         \
+                  tests/test_accv_overlap     \
+                  tests/test_iov_overlap_order \
                   tests/test_acc_overlap      \
                   tests/test_location_consistency \
                   tests/test_puts             \
                   tests/test_puts_gets        \
                   tests/test_puts_gets_dla    \
+                  tests/test_puts_transpose   \
+                  tests/test_strided_multi    \
                   tests/test_putv             \
+                  tests/test_putv_multiwin    \
+                  tests/test_iov_arena        \
+                  tests/test_iov_coalesce     \
+                  tests/test_iov_pattern      \
+                  tests/test_putv_shared      \
+                  tests/test_nb_handles       \
+                  tests/test_nb_aggregate     \
+                  tests/test_nb_aggregate_shared \
+                  tests/test_nb_callback      \
+                  tests/test_nb_callback_thread \
+                  tests/test_waitsome         \
+                  tests/test_ibarrier         \
+                  tests/test_fence_dirty      \
+                  tests/test_putvl            \
                   tests/test_assert           \
                   tests/test_igop             \
                   tests/test_rmw_fadd         \
+                  tests/test_rmw_vec          \
+                  tests/test_nb_rmw           \
+                  tests/test_rmw_ext          \
+                  tests/test_counter          \
+                  tests/test_shm_atomics      \
                   tests/test_parmci           \
                   # end
 
@@ -45,14 +68,37 @@ TESTS          += tests/test_onesided         \
                   tests/test_malloc_group     \
                   tests/test_accs             \
                   tests/test_accs_dla         \
+                  tests/test_accv_overlap     \
+                  tests/test_iov_overlap_order \
                   tests/test_acc_overlap      \
                   tests/test_location_consistency \
                   tests/test_puts             \
                   tests/test_puts_gets        \
                   tests/test_puts_gets_dla    \
+                  tests/test_puts_transpose   \
+                  tests/test_strided_multi    \
                   tests/test_putv             \
+                  tests/test_putv_multiwin    \
+                  tests/test_iov_arena        \
+                  tests/test_iov_coalesce     \
+                  tests/test_iov_pattern      \
+                  tests/test_putv_shared      \
+                  tests/test_nb_handles       \
+                  tests/test_nb_aggregate     \
+                  tests/test_nb_aggregate_shared \
+                  tests/test_nb_callback      \
+                  tests/test_nb_callback_thread \
+                  tests/test_waitsome         \
+                  tests/test_ibarrier         \
+                  tests/test_fence_dirty      \
+                  tests/test_putvl            \
                   tests/test_igop             \
                   tests/test_rmw_fadd         \
+                  tests/test_rmw_vec          \
+                  tests/test_nb_rmw           \
+                  tests/test_rmw_ext          \
+                  tests/test_counter          \
+                  tests/test_shm_atomics      \
                   tests/test_parmci           \
                   # end
 
@@ -75,15 +121,38 @@ tests_test_group_split_LDADD = libarmci.la
 tests_test_malloc_group_LDADD = libarmci.la
 tests_test_accs_LDADD = libarmci.la
 tests_test_accs_dla_LDADD = libarmci.la
+tests_test_accv_overlap_LDADD = libarmci.la
+tests_test_iov_overlap_order_LDADD = libarmci.la
 tests_test_acc_overlap_LDADD = libarmci.la
 tests_test_location_consistency_LDADD = libarmci.la
 tests_test_puts_LDADD = libarmci.la
 tests_test_puts_gets_LDADD = libarmci.la
 tests_test_puts_gets_dla_LDADD = libarmci.la
+tests_test_puts_transpose_LDADD = libarmci.la
+tests_test_strided_multi_LDADD = libarmci.la
 tests_test_putv_LDADD = libarmci.la
+tests_test_putv_multiwin_LDADD = libarmci.la
+tests_test_iov_arena_LDADD = libarmci.la
+tests_test_iov_coalesce_LDADD = libarmci.la
+tests_test_iov_pattern_LDADD = libarmci.la
+tests_test_putv_shared_LDADD = libarmci.la
+tests_test_nb_handles_LDADD = libarmci.la
+tests_test_nb_aggregate_LDADD = libarmci.la
+tests_test_nb_aggregate_shared_LDADD = libarmci.la
+tests_test_nb_callback_LDADD = libarmci.la
+tests_test_nb_callback_thread_LDADD = libarmci.la
+tests_test_waitsome_LDADD = libarmci.la
+tests_test_ibarrier_LDADD = libarmci.la
+tests_test_fence_dirty_LDADD = libarmci.la
+tests_test_putvl_LDADD = libarmci.la
 tests_test_assert_LDADD = libarmci.la
 tests_test_igop_LDADD = libarmci.la
 tests_test_rmw_fadd_LDADD = libarmci.la
+tests_test_rmw_vec_LDADD = libarmci.la
+tests_test_nb_rmw_LDADD = libarmci.la
+tests_test_rmw_ext_LDADD = libarmci.la
+tests_test_counter_LDADD = libarmci.la
+tests_test_shm_atomics_LDADD = libarmci.la
 tests_test_parmci_LDADD = libarmci.la
 tests_test_parmci_SOURCES = tests/test_parmci.c tests/test_parmci_lib.c
 
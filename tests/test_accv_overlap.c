@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NSEG    32
+#define SEGLEN  5
+#define NELEM   (NSEG + SEGLEN - 1)
+
+/* I/O vectors whose remote segments overlap, as produced by a stencil: segment
+ * i covers elements [i, i+SEGLEN) of the target. */
+
+int main(int argc, char **argv) {
+  int     i, j, rank, nranks, errors = 0;
+  double **buffer, *src_buf, *dst_buf;
+  double  one = 1.0;
+  armci_giov_t iov;
+
+  /* Overlap detection requires the IOV checks */
+  setenv("ARMCI_IOV_CHECKS", "1", 1);
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Overlapping I/O Vector Test:\n");
+
+  buffer = malloc(sizeof(double *) * nranks);
+  ARMCI_Malloc((void **) buffer, NELEM*sizeof(double));
+
+  src_buf = ARMCI_Malloc_local(NSEG*SEGLEN*sizeof(double));
+  dst_buf = ARMCI_Malloc_local(NELEM*sizeof(double));
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = 0; i < NELEM; i++)
+    buffer[rank][i] = 0.0;
+  ARMCI_Access_end(buffer[rank]);
+
+  for (i = 0; i < NSEG*SEGLEN; i++)
+    src_buf[i] = 1.0;
+
+  iov.bytes          = SEGLEN*sizeof(double);
+  iov.ptr_array_len  = NSEG;
+  iov.src_ptr_array  = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array  = malloc(NSEG*sizeof(void*));
+
+  for (i = 0; i < NSEG; i++) {
+    iov.src_ptr_array[i] = &src_buf[i*SEGLEN];
+    iov.dst_ptr_array[i] = &buffer[0][i];
+  }
+
+  ARMCI_Barrier();
+
+  /* Every rank accumulates the stencil into rank 0 */
+  ARMCI_AccV(ARMCI_ACC_DBL, &one, &iov, 1, 0);
+
+  ARMCI_Barrier();
+
+  ARMCI_Get(buffer[0], dst_buf, NELEM*sizeof(double), 0);
+
+  for (i = 0; i < NELEM; i++) {
+    int    lo = (i - SEGLEN + 1 > 0) ? i - SEGLEN + 1 : 0;
+    int    hi = (i < NSEG - 1) ? i : NSEG - 1;
+    double expected = (double) nranks * (hi - lo + 1);
+
+    if (dst_buf[i] != expected) {
+      printf("%d: Acc validation failed at %d expected=%f actual=%f\n",
+             rank, i, expected, dst_buf[i]);
+      errors++;
+    }
+  }
+
+  ARMCI_Barrier();
+
+  /* Overlapping puts into my own neighbor: later segments win */
+  for (i = 0; i < NSEG; i++) {
+    for (j = 0; j < SEGLEN; j++)
+      src_buf[i*SEGLEN + j] = i;
+    iov.dst_ptr_array[i] = &buffer[(rank+1) % nranks][i];
+  }
+
+  ARMCI_PutV(&iov, 1, (rank+1) % nranks);
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = 0; i < NELEM; i++) {
+    double expected = (i < NSEG) ? i : NSEG - 1;
+
+    if (buffer[rank][i] != expected) {
+      printf("%d: Put validation failed at %d expected=%f actual=%f\n",
+             rank, i, expected, buffer[rank][i]);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(buffer[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+
+  ARMCI_Free(buffer[rank]);
+  ARMCI_Free_local(src_buf);
+  ARMCI_Free_local(dst_buf);
+  free(buffer);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
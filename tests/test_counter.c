@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NTASK 1000
+
+/* Shared counters: processes draw task ids until they run past NTASK, and
+ * every id below NTASK must be drawn exactly once.  This is repeated with the
+ * default batch, a batch of one and an odd batch size, and then with chunks
+ * that must shrink toward the declared total. */
+
+int main(int argc, char **argv) {
+  int              rank, nranks, i, b, errors = 0;
+  int             *claims;
+  long             value, lo, hi, n, last;
+  const long       batches[] = { 0, 1, 7 };
+  armcix_counter_t ctr;
+  ARMCI_Group      g_world;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Shared Counter Test:\n");
+
+  ARMCI_Group_get_world(&g_world);
+  claims = malloc(NTASK*sizeof(int));
+
+  for (b = 0; b < sizeof(batches)/sizeof(batches[0]); b++) {
+    for (i = 0; i < NTASK; i++)
+      claims[i] = 0;
+
+    ctr = ARMCIX_Counter_create(&g_world, batches[b]);
+
+    while ((value = ARMCIX_Counter_next(ctr)) < NTASK) {
+      if (value < 0) {
+        printf("%d: Drew bad value %ld\n", rank, value);
+        errors++;
+        break;
+      }
+      claims[value]++;
+    }
+
+    ARMCIX_Counter_destroy(ctr);
+
+    armci_msg_igop(claims, NTASK, "+");
+
+    for (i = 0; i < NTASK; i++) {
+      if (claims[i] != 1) {
+        printf("%d: Batch %ld, value %d was drawn %d times\n", rank, batches[b], i, claims[i]);
+        errors++;
+      }
+    }
+  }
+
+  for (i = 0; i < NTASK; i++)
+    claims[i] = 0;
+
+  ctr = ARMCIX_Counter_create(&g_world, 0);
+  ARMCIX_Counter_set_total(ctr, NTASK);
+
+  for (last = NTASK; (n = ARMCIX_Counter_next_chunk(ctr, &lo, &hi)) > 0; last = n) {
+    if (n > last || lo < 0 || hi > NTASK) {
+      printf("%d: Drew bad chunk [%ld, %ld) after a chunk of %ld\n", rank, lo, hi, last);
+      errors++;
+      break;
+    }
+    for (value = lo; value < hi; value++)
+      claims[value]++;
+  }
+
+  ARMCIX_Counter_destroy(ctr);
+
+  armci_msg_igop(claims, NTASK, "+");
+
+  for (i = 0; i < NTASK; i++) {
+    if (claims[i] != 1) {
+      printf("%d: Chunked, value %d was drawn %d times\n", rank, i, claims[i]);
+      errors++;
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  free(claims);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
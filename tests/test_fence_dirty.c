@@ -0,0 +1,117 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NALLOC 4
+#define N      16
+
+/* Fence and AllFence must complete writes on exactly the allocations that
+ * were written, across rounds that touch different subsets of allocations and
+ * targets.  The message barrier doesn't fence, so only ARMCI_Fence/AllFence
+ * make the data visible. */
+
+static int check(int **bufs[], int rank, int round, int writer, int a_written) {
+  int a, i, errors = 0;
+
+  for (a = 0; a < NALLOC; a++) {
+    const int expected = (a == a_written) ? writer*100 + round : -1;
+
+    ARMCI_Access_begin(bufs[a][rank]);
+    for (i = 0; i < N; i++) {
+      if (bufs[a][rank][i] != expected) {
+        printf("%d: Round %d validation failed alloc %d at %d expected=%d actual=%d\n",
+               rank, round, a, i, expected, bufs[a][rank][i]);
+        errors++;
+      }
+      bufs[a][rank][i] = -1;
+    }
+    ARMCI_Access_end(bufs[a][rank]);
+  }
+
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  int   rank, nranks, a, i, round, errors = 0;
+  int **bufs[NALLOC];
+  int  *loc;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Fence Dirty Target Test:\n");
+
+  for (a = 0; a < NALLOC; a++) {
+    bufs[a] = malloc(nranks*sizeof(int*));
+    ARMCI_Malloc((void**) bufs[a], N*sizeof(int));
+
+    ARMCI_Access_begin(bufs[a][rank]);
+    for (i = 0; i < N; i++)
+      bufs[a][rank][i] = -1;
+    ARMCI_Access_end(bufs[a][rank]);
+  }
+
+  loc = ARMCI_Malloc_local(N*sizeof(int));
+
+  ARMCI_Barrier();
+
+  for (round = 0; round < 2*NALLOC; round++) {
+    const int target = (rank + 1 + round) % nranks;
+    const int writer = (rank - 1 - round % nranks + 2*nranks) % nranks;
+    const int a      = round % NALLOC;
+    int       scratch;
+
+    for (i = 0; i < N; i++)
+      loc[i] = rank*100 + round;
+
+    /* Read from another allocation first, so that it has pending operations
+     * that aren't writes */
+    ARMCI_Get(bufs[(a+1) % NALLOC][target], &scratch, sizeof(int), target);
+
+    if (round % 2 == 0) {
+      /* Implicit-handle put, completed locally by WaitProc, remotely by Fence */
+      ARMCI_NbPut(loc, bufs[a][target], N*sizeof(int), target, NULL);
+      ARMCI_WaitProc(target);
+      ARMCI_Fence(target);
+    } else {
+      ARMCI_NbPut(loc, bufs[a][target], N*sizeof(int), target, NULL);
+      ARMCI_WaitAll();
+      ARMCI_AllFence();
+    }
+
+    armci_msg_barrier();
+
+    errors += check(bufs, rank, round, writer, a);
+
+    armci_msg_barrier();
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  for (a = 0; a < NALLOC; a++) {
+    ARMCI_Free(bufs[a][rank]);
+    free(bufs[a]);
+  }
+  ARMCI_Free_local(loc);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
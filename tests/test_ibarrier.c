@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define N      1024
+#define NPHASE 3
+
+/* Each process writes to its right neighbor and enters a nonblocking barrier,
+ * completing it with ARMCI_Test, ARMCI_Wait and ARMCIX_Waitany.  Once the
+ * barrier completes, the left neighbor's data must be visible. */
+
+static int check(int *buf, int left, int phase, int rank) {
+  int i, errors = 0;
+
+  ARMCI_Access_begin(buf);
+  for (i = 0; i < N; i++) {
+    if (buf[i] != phase*N*1000 + left*N + i) {
+      if (errors < 10)
+        printf("%d: Phase %d validation failed at %d expected=%d actual=%d\n",
+               rank, phase, i, phase*N*1000 + left*N + i, buf[i]);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(buf);
+
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  int          rank, nranks, right, left, phase, i, index, errors = 0;
+  int        **base;
+  int         *loc;
+  armci_hdl_t  handles[2];
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Nonblocking Barrier Test:\n");
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, N*sizeof(int));
+
+  loc   = ARMCI_Malloc_local(N*sizeof(int));
+  right = (rank + 1) % nranks;
+  left  = (rank + nranks - 1) % nranks;
+
+  ARMCI_Barrier();
+
+  for (phase = 0; phase < NPHASE; phase++) {
+    for (i = 0; i < N; i++)
+      loc[i] = phase*N*1000 + rank*N + i;
+
+    ARMCI_INIT_HANDLE(&handles[0]);
+    ARMCI_INIT_HANDLE(&handles[1]);
+
+    switch (phase) {
+      case 0:
+        /* Blocking put, poll the barrier */
+        ARMCI_Put(loc, base[right], N*sizeof(int), right);
+        ARMCIX_Ibarrier(&handles[0]);
+
+        while (ARMCI_Test(&handles[0]))
+          ;
+        break;
+
+      case 1:
+        /* The barrier shares a handle with the put */
+        ARMCI_NbPut(loc, base[right], N*sizeof(int), right, &handles[0]);
+        ARMCIX_Ibarrier(&handles[0]);
+        ARMCI_Wait(&handles[0]);
+        break;
+
+      case 2:
+        /* Aggregated puts are issued before the barrier */
+        ARMCI_SET_AGGREGATE_HANDLE(&handles[1]);
+        for (i = 0; i < N; i++)
+          ARMCI_NbPut(&loc[i], base[right] + i, sizeof(int), right, &handles[1]);
+        ARMCIX_Ibarrier(&handles[1]);
+
+        ARMCIX_Waitany(2, handles, &index);
+        if (index != 1) {
+          printf("%d: Waitany returned %d, expected 1\n", rank, index);
+          errors++;
+        }
+
+        ARMCIX_Waitany(2, handles, &index);
+        if (index != -1) {
+          printf("%d: Waitany returned %d, expected -1\n", rank, index);
+          errors++;
+        }
+
+        ARMCI_UNSET_AGGREGATE_HANDLE(&handles[1]);
+        break;
+    }
+
+    errors += check(base[rank], left, phase, rank);
+
+    /* Nobody overwrites the buffer before it has been checked */
+    ARMCI_Barrier();
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Free(base[rank]);
+  ARMCI_Free_local(loc);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armci_internals.h>
+
+#define NSEG  32768
+#define STEP  7919  /* Coprime with NSEG, scatters the segments */
+
+/* A large, scattered I/O vector needs nested scratch buffers that don't fit
+ * in the scratch arena the first time.  The arena must grow to hold them, so
+ * that repeating the operation doesn't fall back to the heap. */
+
+int main(int argc, char **argv) {
+  int          i, rank, nranks, peer, errors = 0;
+  int        **buffer, *src_buf, *dst_buf;
+  unsigned long first, second;
+  armci_giov_t iov;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI I/O Vector Scratch Arena Test:\n");
+
+  peer = (rank+1) % nranks;
+
+  buffer = malloc(sizeof(int *) * nranks);
+  ARMCI_Malloc((void **) buffer, 2*NSEG*sizeof(int));
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = 0; i < 2*NSEG; i++)
+    buffer[rank][i] = -1;
+  ARMCI_Access_end(buffer[rank]);
+
+  src_buf = malloc(NSEG*sizeof(int));
+  dst_buf = malloc(2*NSEG*sizeof(int));
+
+  for (i = 0; i < NSEG; i++)
+    src_buf[i] = rank*NSEG + i;
+
+  /* Segment i goes to every other element, in scattered order */
+  iov.bytes          = sizeof(int);
+  iov.ptr_array_len  = NSEG;
+  iov.src_ptr_array  = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array  = malloc(NSEG*sizeof(void*));
+
+  for (i = 0; i < NSEG; i++) {
+    iov.src_ptr_array[i] = &src_buf[i];
+    iov.dst_ptr_array[i] = &buffer[peer][2*(int)(((long) i*STEP) % NSEG)];
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_PutV(&iov, 1, peer);
+  first = ARMCII_Arena_heap_count();
+
+  ARMCI_PutV(&iov, 1, peer);
+  second = ARMCII_Arena_heap_count();
+
+  if (second != first) {
+    printf("%d: Repeated vector fell back to the heap %lu times (first call: %lu)\n",
+           rank, second - first, first);
+    errors++;
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Get(buffer[rank], dst_buf, 2*NSEG*sizeof(int), rank);
+
+  for (i = 0; i < NSEG; i++) {
+    const int src_rank = (rank + nranks - 1) % nranks;
+    const int j        = (int) (((long) i*STEP) % NSEG);
+
+    if (dst_buf[2*j] != src_rank*NSEG + i || dst_buf[2*j+1] != -1) {
+      if (errors < 10)
+        printf("%d: Validation failed for segment %d: %d %d\n", rank, i, dst_buf[2*j], dst_buf[2*j+1]);
+      errors++;
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Barrier();
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+  free(src_buf);
+  free(dst_buf);
+
+  ARMCI_Free(buffer[rank]);
+  free(buffer);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armci_internals.h>
+
+#define NSEG   16
+#define SEGLEN 4
+#define NLIST  6
+#define BUFLEN (3*NSEG*SEGLEN)
+
+/* IOV coalescing: segments that are adjacent at both the origin and the
+ * target merge into one block, and segments adjacent on only one side don't.
+ * Each list is checked for the number of blocks it coalesces into, then put,
+ * accumulated and read back with ARMCI_IOV_COALESCE on and off. */
+
+typedef struct {
+  const char *name;
+  int         nblk;   /* Blocks after coalescing */
+} list_t;
+
+static const list_t lists[NLIST] = {
+  { "contiguous",             1      },
+  { "contiguous, descending", 1      },
+  { "contiguous in pairs",    NSEG/2 },
+  { "contiguous locally",     NSEG   },
+  { "contiguous remotely",    NSEG   },
+  { "non-contiguous",         NSEG   },
+};
+
+/* Element offsets of segment i of a list at the origin and the target */
+static void offsets(int l, int i, int *loc, int *rem) {
+  switch (l) {
+    case 0:  *loc = i*SEGLEN;               *rem = i*SEGLEN;                          break;
+    case 1:  *loc = (NSEG-1-i)*SEGLEN;      *rem = (NSEG-1-i)*SEGLEN;                 break;
+    case 2:  *loc = i*SEGLEN;               *rem = (i/2)*3*SEGLEN + (i%2)*SEGLEN;     break;
+    case 3:  *loc = i*SEGLEN;               *rem = 2*i*SEGLEN;                        break;
+    case 4:  *loc = 2*i*SEGLEN;             *rem = i*SEGLEN;                          break;
+    default: *loc = 2*i*SEGLEN + SEGLEN/2;  *rem = 3*i*SEGLEN;                        break;
+  }
+}
+
+static void make_iov(armci_giov_t *iov, int l, int *loc_buf, int *rem_buf) {
+  int i, loc, rem;
+
+  iov->bytes         = SEGLEN*sizeof(int);
+  iov->ptr_array_len = NSEG;
+
+  for (i = 0; i < NSEG; i++) {
+    offsets(l, i, &loc, &rem);
+    iov->src_ptr_array[i] = &loc_buf[loc];
+    iov->dst_ptr_array[i] = &rem_buf[rem];
+  }
+}
+
+static int check_blocks(int rank) {
+  int   l, nblk, errors = 0;
+  int  *loc_buf, *rem_buf, len[NSEG];
+  void *loc_out[NSEG], *rem_out[NSEG];
+  armci_giov_t iov;
+
+  loc_buf = malloc(BUFLEN*sizeof(int));
+  rem_buf = malloc(BUFLEN*sizeof(int));
+  iov.src_ptr_array = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array = malloc(NSEG*sizeof(void*));
+
+  for (l = 0; l < NLIST; l++) {
+    make_iov(&iov, l, loc_buf, rem_buf);
+    nblk = ARMCII_Iov_coalesce(iov.src_ptr_array, iov.dst_ptr_array, NSEG, iov.bytes, loc_out, rem_out, len);
+
+    if (nblk != lists[l].nblk) {
+      printf("%d: List \"%s\" coalesced into %d blocks, expected %d\n", rank, lists[l].name, nblk, lists[l].nblk);
+      errors++;
+    }
+  }
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+  free(loc_buf);
+  free(rem_buf);
+
+  return errors;
+}
+
+static int check_data(int rank, int nranks, int coalesce) {
+  int   l, i, j, loc, rem, peer, errors = 0;
+  int **base, *src_buf, *get_buf, *expected;
+  armci_giov_t iov;
+
+  setenv("ARMCI_IOV_COALESCE", coalesce ? "1" : "0", 1);
+  ARMCI_Init();
+
+  peer = (rank+1) % nranks;
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, BUFLEN*sizeof(int));
+
+  src_buf  = malloc(BUFLEN*sizeof(int));
+  get_buf  = malloc(BUFLEN*sizeof(int));
+  expected = malloc(BUFLEN*sizeof(int));
+  iov.src_ptr_array = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array = malloc(NSEG*sizeof(void*));
+
+  for (i = 0; i < BUFLEN; i++)
+    src_buf[i] = rank*BUFLEN + i;
+
+  for (l = 0; l < NLIST; l++) {
+    int one = 1;
+
+    ARMCI_Access_begin(base[rank]);
+    for (i = 0; i < BUFLEN; i++)
+      base[rank][i] = -1;
+    ARMCI_Access_end(base[rank]);
+
+    ARMCI_Barrier();
+
+    /* Put the segments, then add them once more */
+    make_iov(&iov, l, src_buf, base[peer]);
+    ARMCI_PutV(&iov, 1, peer);
+    ARMCI_AccV(ARMCI_ACC_INT, &one, &iov, 1, peer);
+
+    ARMCI_Barrier();
+
+    /* Read the target back through the same list */
+    for (i = 0; i < BUFLEN; i++) {
+      get_buf[i]  = -2;
+      expected[i] = -2;
+    }
+
+    for (i = 0; i < NSEG; i++) {
+      void *tmp = iov.src_ptr_array[i];
+      iov.src_ptr_array[i] = iov.dst_ptr_array[i];
+      iov.dst_ptr_array[i] = (int*) get_buf + ((int*) tmp - src_buf);
+
+      offsets(l, i, &loc, &rem);
+      for (j = 0; j < SEGLEN; j++)
+        expected[loc+j] = 2*src_buf[loc+j];
+    }
+
+    ARMCI_GetV(&iov, 1, peer);
+
+    for (i = 0; i < BUFLEN; i++) {
+      if (get_buf[i] != expected[i]) {
+        if (errors < 10)
+          printf("%d: Coalescing %s, list \"%s\": element %d is %d, expected %d\n",
+                 rank, coalesce ? "on" : "off", lists[l].name, i, get_buf[i], expected[i]);
+        errors++;
+      }
+    }
+
+    /* Gaps between the target segments are untouched */
+    ARMCI_Barrier();
+    ARMCI_Access_begin(base[rank]);
+    for (i = 0, j = 0; i < BUFLEN; i++)
+      j += (base[rank][i] == -1);
+    ARMCI_Access_end(base[rank]);
+
+    if (j != BUFLEN - NSEG*SEGLEN) {
+      printf("%d: Coalescing %s, list \"%s\": %d elements written, expected %d\n",
+             rank, coalesce ? "on" : "off", lists[l].name, BUFLEN - j, NSEG*SEGLEN);
+      errors++;
+    }
+  }
+
+  ARMCI_Barrier();
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+  free(src_buf);
+  free(get_buf);
+  free(expected);
+
+  ARMCI_Free(base[rank]);
+  free(base);
+
+  ARMCI_Finalize();
+
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  int rank, nranks, errors = 0;
+
+  MPI_Init(&argc, &argv);
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI I/O Vector Coalescing Test:\n");
+
+  errors += check_blocks(rank);
+  errors += check_data(rank, nranks, 1);
+  errors += check_data(rank, nranks, 0);
+
+  MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armci_internals.h>
+
+#define NSEG_MAX 256
+#define SEGLEN   4
+#define STEP     37  /* Coprime with the segment counts, shuffles the segments */
+#define BUFLEN   (2*NSEG_MAX*SEGLEN)
+
+/* Overlap detection for I/O vectors that are not in address order, which
+ * must be sorted first: short vectors take the insertion sort and long ones
+ * the radix sort.  Segment k goes to every other block of the target, except
+ * that in the overlapping vectors one segment is moved onto the last element
+ * of its neighbor.  Each vector is checked for the detection result, then
+ * accumulated and checked at the target. */
+
+/* Element offset of segment k at the target */
+static int seg_offset(int k, int nseg, int overlap) {
+  if (overlap && k == nseg/2)
+    return 2*(k-1)*SEGLEN + SEGLEN-1;
+  else
+    return 2*k*SEGLEN;
+}
+
+/* Segment at position i of the vector */
+static int seg_index(int i, int nseg, int shuffled) {
+  if (shuffled)
+    return (int) (((long) i*STEP) % nseg);
+  else
+    return nseg-1-i;
+}
+
+int main(int argc, char **argv) {
+  const int nsegs[] = { 16, NSEG_MAX };
+  int   c, shuffled, overlap, i, j, k, rank, nranks, peer, src_rank, detected, errors = 0;
+  int **base, *src_buf, *expected;
+  armci_giov_t iov;
+
+  /* Overlap detection requires the IOV checks */
+  setenv("ARMCI_IOV_CHECKS", "1", 1);
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Unordered I/O Vector Overlap Test:\n");
+
+  peer     = (rank+1) % nranks;
+  src_rank = (rank+nranks-1) % nranks;
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, BUFLEN*sizeof(int));
+
+  src_buf  = malloc(NSEG_MAX*SEGLEN*sizeof(int));
+  expected = malloc(BUFLEN*sizeof(int));
+  iov.src_ptr_array = malloc(NSEG_MAX*sizeof(void*));
+  iov.dst_ptr_array = malloc(NSEG_MAX*sizeof(void*));
+
+  /* Segment k holds (rank+1)*(k+1) */
+  for (k = 0; k < NSEG_MAX; k++)
+    for (j = 0; j < SEGLEN; j++)
+      src_buf[k*SEGLEN + j] = (rank+1)*(k+1);
+
+  for (c = 0; c < (int) (sizeof(nsegs)/sizeof(nsegs[0])); c++) {
+    for (shuffled = 0; shuffled <= 1; shuffled++) {
+      for (overlap = 0; overlap <= 1; overlap++) {
+        const int   nseg  = nsegs[c];
+        const char *order = shuffled ? "shuffled" : "descending";
+        int one = 1;
+
+        iov.bytes         = SEGLEN*sizeof(int);
+        iov.ptr_array_len = nseg;
+
+        for (i = 0; i < nseg; i++) {
+          k = seg_index(i, nseg, shuffled);
+          iov.src_ptr_array[i] = &src_buf[k*SEGLEN];
+          iov.dst_ptr_array[i] = &base[peer][seg_offset(k, nseg, overlap)];
+        }
+
+        detected = ARMCII_Iov_check_overlap(iov.dst_ptr_array, nseg, iov.bytes);
+
+        if (detected != overlap) {
+          printf("%d: %d %s segments: overlap %s\n", rank, nseg, order,
+                 detected ? "detected in a disjoint vector" : "not detected");
+          errors++;
+        }
+
+        ARMCI_Access_begin(base[rank]);
+        for (i = 0; i < BUFLEN; i++)
+          base[rank][i] = 0;
+        ARMCI_Access_end(base[rank]);
+
+        ARMCI_Barrier();
+
+        ARMCI_AccV(ARMCI_ACC_INT, &one, &iov, 1, peer);
+
+        ARMCI_Barrier();
+
+        for (i = 0; i < BUFLEN; i++)
+          expected[i] = 0;
+
+        for (k = 0; k < nseg; k++)
+          for (j = 0; j < SEGLEN; j++)
+            expected[seg_offset(k, nseg, overlap) + j] += (src_rank+1)*(k+1);
+
+        ARMCI_Access_begin(base[rank]);
+        for (i = 0; i < BUFLEN; i++) {
+          if (base[rank][i] != expected[i]) {
+            if (errors < 10)
+              printf("%d: %d %s %s segments: element %d is %d, expected %d\n",
+                     rank, nseg, order, overlap ? "overlapping" : "disjoint",
+                     i, base[rank][i], expected[i]);
+            errors++;
+          }
+        }
+        ARMCI_Access_end(base[rank]);
+
+        ARMCI_Barrier();
+      }
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+  free(src_buf);
+  free(expected);
+
+  ARMCI_Free(base[rank]);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,208 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armci_internals.h>
+
+#define NSEG   16
+#define SEGLEN 4
+#define ROW    4
+#define NLIST  4
+#define BUFLEN (3*NSEG*SEGLEN)
+
+/* Regular I/O vectors with ARMCI_STRIDED_METHOD=DIRECT: vectors with a one-
+ * or two-level stride pattern are detected and sent with vector datatypes,
+ * and vectors whose pattern breaks partway through fall back to the generic
+ * path.  Each list is checked for the pattern that is detected, then put,
+ * accumulated and read back. */
+
+typedef struct {
+  const char *name;
+  int         levels; /* 0 if the vector is not regular */
+  int         inner;
+  int         outer;
+} list_t;
+
+static const list_t lists[NLIST] = {
+  { "one level",                  1, NSEG, 1        },
+  { "two levels",                 2, ROW,  NSEG/ROW },
+  { "breaks after the first row", 0, 0,    0        },
+  { "breaks in the last row",     0, 0,    0        },
+};
+
+/* Element offsets of segment i of a list at the origin and the target */
+static void offsets(int l, int i, int *loc, int *rem) {
+  switch (l) {
+    case 0:
+      *loc = 2*i*SEGLEN;
+      *rem = 3*i*SEGLEN;
+      break;
+    case 1:
+      *loc = i*SEGLEN;
+      *rem = (i/ROW)*2*ROW*SEGLEN + (i%ROW)*SEGLEN;
+      break;
+    case 2:
+      *loc = 2*i*SEGLEN;
+      *rem = 3*i*SEGLEN + (i >= NSEG/2+2 ? SEGLEN : 0);
+      break;
+    default:
+      *loc = i*SEGLEN;
+      *rem = (i/ROW)*2*ROW*SEGLEN + (i%ROW)*SEGLEN + (i == NSEG-1 ? SEGLEN : 0);
+      break;
+  }
+}
+
+static void make_iov(armci_giov_t *iov, int l, int *loc_buf, int *rem_buf) {
+  int i, loc, rem;
+
+  iov->bytes         = SEGLEN*sizeof(int);
+  iov->ptr_array_len = NSEG;
+
+  for (i = 0; i < NSEG; i++) {
+    offsets(l, i, &loc, &rem);
+    iov->src_ptr_array[i] = &loc_buf[loc];
+    iov->dst_ptr_array[i] = &rem_buf[rem];
+  }
+}
+
+int main(int argc, char **argv) {
+  int   l, i, j, loc, rem, rank, nranks, peer, src_rank, regular, errors = 0;
+  int **base, *src_buf, *get_buf, *expected;
+  armci_giov_t iov;
+  armcii_iov_pattern_t pat;
+
+  setenv("ARMCI_STRIDED_METHOD", "DIRECT", 1);
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI I/O Vector Pattern Test:\n");
+
+  peer     = (rank+1) % nranks;
+  src_rank = (rank+nranks-1) % nranks;
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, BUFLEN*sizeof(int));
+
+  src_buf  = malloc(BUFLEN*sizeof(int));
+  get_buf  = malloc(BUFLEN*sizeof(int));
+  expected = malloc(BUFLEN*sizeof(int));
+  iov.src_ptr_array = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array = malloc(NSEG*sizeof(void*));
+
+  for (i = 0; i < BUFLEN; i++)
+    src_buf[i] = rank*BUFLEN + i;
+
+  for (l = 0; l < NLIST; l++) {
+    int one = 1;
+
+    make_iov(&iov, l, src_buf, base[peer]);
+    regular = ARMCII_Iov_find_pattern(iov.src_ptr_array, iov.dst_ptr_array, NSEG, iov.bytes, &pat);
+
+    if (regular != (lists[l].levels > 0)) {
+      printf("%d: List \"%s\" %s detected as regular\n", rank, lists[l].name, regular ? "was" : "was not");
+      errors++;
+    }
+    else if (regular && (   pat.levels != lists[l].levels || pat.inner != lists[l].inner
+                         || pat.outer  != lists[l].outer)) {
+      printf("%d: List \"%s\" has %d level(s), %d x %d segments, expected %d level(s), %d x %d segments\n",
+             rank, lists[l].name, pat.levels, pat.outer, pat.inner,
+             lists[l].levels, lists[l].outer, lists[l].inner);
+      errors++;
+    }
+
+    ARMCI_Access_begin(base[rank]);
+    for (i = 0; i < BUFLEN; i++)
+      base[rank][i] = -1;
+    ARMCI_Access_end(base[rank]);
+
+    ARMCI_Barrier();
+
+    /* Put the segments, then add them once more */
+    ARMCI_PutV(&iov, 1, peer);
+    ARMCI_AccV(ARMCI_ACC_INT, &one, &iov, 1, peer);
+
+    ARMCI_Barrier();
+
+    /* Read the target back through the same list */
+    for (i = 0; i < BUFLEN; i++) {
+      get_buf[i]  = -2;
+      expected[i] = -2;
+    }
+
+    for (i = 0; i < NSEG; i++) {
+      offsets(l, i, &loc, &rem);
+      iov.src_ptr_array[i] = &base[peer][rem];
+      iov.dst_ptr_array[i] = &get_buf[loc];
+
+      for (j = 0; j < SEGLEN; j++)
+        expected[loc+j] = 2*src_buf[loc+j];
+    }
+
+    ARMCI_GetV(&iov, 1, peer);
+
+    for (i = 0; i < BUFLEN; i++) {
+      if (get_buf[i] != expected[i]) {
+        if (errors < 10)
+          printf("%d: List \"%s\": element %d is %d, expected %d\n",
+                 rank, lists[l].name, i, get_buf[i], expected[i]);
+        errors++;
+      }
+    }
+
+    /* Segments land where the list puts them, and the gaps are untouched */
+    for (i = 0; i < BUFLEN; i++)
+      expected[i] = -1;
+
+    for (i = 0; i < NSEG; i++) {
+      offsets(l, i, &loc, &rem);
+      for (j = 0; j < SEGLEN; j++)
+        expected[rem+j] = 2*(src_rank*BUFLEN + loc+j);
+    }
+
+    ARMCI_Barrier();
+    ARMCI_Access_begin(base[rank]);
+    for (i = 0; i < BUFLEN; i++) {
+      if (base[rank][i] != expected[i]) {
+        if (errors < 10)
+          printf("%d: List \"%s\": target element %d is %d, expected %d\n",
+                 rank, lists[l].name, i, base[rank][i], expected[i]);
+        errors++;
+      }
+    }
+    ARMCI_Access_end(base[rank]);
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Barrier();
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+  free(src_buf);
+  free(get_buf);
+  free(expected);
+
+  ARMCI_Free(base[rank]);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
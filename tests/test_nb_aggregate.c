@@ -0,0 +1,165 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NALLOC 2
+#define N      16384  /* The accumulates overflow one staging buffer */
+
+/* Small puts and accumulates on an aggregate handle are queued and issued in
+ * batches.  Exercise batches to several targets and allocations, segments in
+ * descending and scattered order, overlapping accumulates, scaled
+ * accumulates and segments of different sizes, completing with Wait, Test
+ * and ARMCI_SET_AGGREGATE_HANDLE. */
+
+int main(int argc, char **argv) {
+  int          rank, nranks, a, i, t, errors = 0;
+  int        **bufs[NALLOC];
+  int         *loc, *get_buf;
+  char        *scaled;
+  armci_hdl_t  handle;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Aggregate Handle Test:\n");
+
+  for (a = 0; a < NALLOC; a++) {
+    bufs[a] = malloc(nranks*sizeof(int*));
+    ARMCI_Malloc((void**) bufs[a], N*sizeof(int));
+
+    ARMCI_Access_begin(bufs[a][rank]);
+    for (i = 0; i < N; i++)
+      bufs[a][rank][i] = 0;
+    ARMCI_Access_end(bufs[a][rank]);
+  }
+
+  loc     = ARMCI_Malloc_local(N*sizeof(int));
+  get_buf = ARMCI_Malloc_local(N*sizeof(int));
+
+  for (i = 0; i < N; i++)
+    loc[i] = rank*N + i;
+
+  ARMCI_Barrier();
+
+  /* Puts: each process writes its slice of the first half of both
+   * allocations on every process, one element at a time in descending order,
+   * alternating between allocations */
+  ARMCI_INIT_HANDLE(&handle);
+  ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+  for (t = 0; t < nranks; t++) {
+    const int trg = (rank + t) % nranks;
+    const int off = rank * (N/2/nranks);
+
+    for (i = N/2/nranks - 1; i >= 0; i--) {
+      for (a = 0; a < NALLOC; a++)
+        ARMCI_NbPut(&loc[off + i], bufs[a][trg] + off + i, sizeof(int), trg, &handle);
+
+      /* Marking the handle again must complete the queued puts, not drop
+       * them (remote ones, since local puts aren't queued) */
+      if (t == 1 && i == N/4/nranks)
+        ARMCI_SET_AGGREGATE_HANDLE(&handle);
+    }
+  }
+
+  ARMCI_Wait(&handle);
+  ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+  ARMCI_AllFence();
+  ARMCI_Barrier();
+
+  /* Accumulates into the second half: every process adds 2*loc to every
+   * element (twice, overlapping), scaled by 3 into every other pair, in
+   * segments of 1 and 2 elements, in an order scattered by a stride coprime
+   * with N/4 */
+  ARMCI_INIT_HANDLE(&handle);
+  ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+  for (t = 0; t < nranks; t++) {
+    const int trg = (rank + t) % nranks;
+    int       one = 1, three = 3, k;
+
+    for (k = 0; k < N/4; k++) {
+      const int j = N/2 + ((k * 7) % (N/4)) * 2;
+
+      ARMCI_NbAcc(ARMCI_ACC_INT, &one, &loc[j], bufs[0][trg] + j, 2*sizeof(int), trg, &handle);
+      ARMCI_NbAcc(ARMCI_ACC_INT, &one, &loc[j], bufs[0][trg] + j, sizeof(int), trg, &handle);
+      ARMCI_NbAcc(ARMCI_ACC_INT, &one, &loc[j+1], bufs[0][trg] + j + 1, sizeof(int), trg, &handle);
+
+      if (k % 2 == 0)
+        ARMCI_NbAcc(ARMCI_ACC_INT, &three, &loc[j], bufs[1][trg] + j, 2*sizeof(int), trg, &handle);
+    }
+  }
+
+  while (ARMCI_Test(&handle))
+    ;
+
+  ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+  ARMCI_AllFence();
+  ARMCI_Barrier();
+
+  /* Pair k*7 % (N/4) of the second half was scaled into allocation 1 when k
+   * is even.  7 and N/4 are coprime, so every pair is hit once. */
+  scaled = malloc(N/4);
+  for (i = 0; i < N/4; i++)
+    scaled[(i * 7) % (N/4)] = (i % 2 == 0);
+
+  for (a = 0; a < NALLOC; a++) {
+    ARMCI_Get(bufs[a][rank], get_buf, N*sizeof(int), rank);
+
+    for (i = 0; i < N; i++) {
+      int expected = 0, p;
+
+      if (i < N/2) {
+        /* Written by the process that owns this slice of the first half */
+        p = i / (N/2/nranks);
+        if (p < nranks)
+          expected = p*N + i;
+      } else if (a == 0) {
+        for (p = 0; p < nranks; p++)
+          expected += 2*(p*N + i);
+      } else if (scaled[(i - N/2)/2]) {
+        for (p = 0; p < nranks; p++)
+          expected += 3*(p*N + i);
+      }
+
+      if (get_buf[i] != expected) {
+        if (errors < 10)
+          printf("%d: Validation failed alloc %d at %d expected=%d actual=%d\n",
+                 rank, a, i, expected, get_buf[i]);
+        errors++;
+      }
+    }
+  }
+
+  free(scaled);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  for (a = 0; a < NALLOC; a++) {
+    ARMCI_Free(bufs[a][rank]);
+    free(bufs[a]);
+  }
+  ARMCI_Free_local(loc);
+  ARMCI_Free_local(get_buf);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define N 64
+
+/* Puts and accumulates on an aggregate handle whose source is the local slice
+ * of an allocation, with ARMCI_SHR_BUF_METHOD=COPY.  Shared sources must not
+ * be copied into the handle's staging buffer without the shared buffer guard,
+ * so they are issued directly; private sources are still queued. */
+
+int main(int argc, char **argv) {
+  int          rank, nranks, peer, src_rank, i, one = 1, errors = 0;
+  int        **src, **dst;
+  int         *loc;
+  armci_hdl_t  handle;
+
+  setenv("ARMCI_SHR_BUF_METHOD", "COPY", 1);
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Aggregate Handle Shared Source Test:\n");
+
+  peer     = (rank + 1) % nranks;
+  src_rank = (rank + nranks - 1) % nranks;
+
+  src = malloc(nranks*sizeof(int*));
+  dst = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) src, N*sizeof(int));
+  ARMCI_Malloc((void**) dst, 2*N*sizeof(int));
+
+  ARMCI_Access_begin(src[rank]);
+  for (i = 0; i < N; i++)
+    src[rank][i] = rank*N + i;
+  ARMCI_Access_end(src[rank]);
+
+  ARMCI_Access_begin(dst[rank]);
+  for (i = 0; i < 2*N; i++)
+    dst[rank][i] = 0;
+  ARMCI_Access_end(dst[rank]);
+
+  loc = malloc(N*sizeof(int));
+  for (i = 0; i < N; i++)
+    loc[i] = rank*N + i;
+
+  ARMCI_Barrier();
+
+  /* Put, then add, each element of the shared source into the first half */
+  ARMCI_INIT_HANDLE(&handle);
+  ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+  for (i = 0; i < N; i++) {
+    ARMCI_NbPut(&src[rank][i], dst[peer] + i, sizeof(int), peer, &handle);
+    ARMCI_NbAcc(ARMCI_ACC_INT, &one, &src[rank][i], dst[peer] + i, sizeof(int), peer, &handle);
+  }
+
+  if (handle.agg != NULL) {
+    printf("%d: Operations from a shared source were staged\n", rank);
+    errors++;
+  }
+
+  ARMCI_Wait(&handle);
+
+  /* The same from a private source into the second half, which is queued
+   * unless the target is local */
+  for (i = 0; i < N; i++) {
+    ARMCI_NbPut(&loc[i], dst[peer] + N + i, sizeof(int), peer, &handle);
+    ARMCI_NbAcc(ARMCI_ACC_INT, &one, &loc[i], dst[peer] + N + i, sizeof(int), peer, &handle);
+  }
+
+  if (peer != rank && handle.agg == NULL) {
+    printf("%d: Operations from a private source were not staged\n", rank);
+    errors++;
+  }
+
+  ARMCI_Wait(&handle);
+  ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+  ARMCI_AllFence();
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(dst[rank]);
+  for (i = 0; i < 2*N; i++) {
+    const int expected = 2*(src_rank*N + i % N);
+
+    if (dst[rank][i] != expected) {
+      if (errors < 10)
+        printf("%d: Validation failed at %d expected=%d actual=%d\n",
+               rank, i, expected, dst[rank][i]);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(dst[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Barrier();
+
+  ARMCI_Free(src[rank]);
+  ARMCI_Free(dst[rank]);
+  free(src);
+  free(dst);
+  free(loc);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
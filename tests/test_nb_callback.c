@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NHDL 4
+#define N    512
+
+/* Completion callbacks drive a two-stage dataflow: the callback of each
+ * handle's first get launches a second get on the same handle.  A barrier
+ * handle and an inactive handle also get callbacks.  Everything is driven by
+ * ARMCIX_Progress. */
+
+typedef struct {
+  int   blk;
+  int   stage;     /* Completed gets on this handle */
+  int **base;
+  int  *loc;
+  int   peer;
+} task_t;
+
+static void get_done(armci_hdl_t *handle, void *arg) {
+  task_t *t = arg;
+
+  /* Launch the dependent get into the second half of the block */
+  if (++t->stage == 1) {
+    ARMCI_INIT_HANDLE(handle);
+    ARMCI_NbGet(t->base[t->peer] + t->blk*N + N/2, t->loc + t->blk*N + N/2,
+                N/2*sizeof(int), t->peer, handle);
+    ARMCIX_Callback_hdl(handle, get_done, t);
+  }
+}
+
+static void count_done(armci_hdl_t *handle, void *arg) {
+  (*(int*) arg)++;
+}
+
+int main(int argc, char **argv) {
+  int          rank, nranks, peer, h, i, pending, errors = 0;
+  int          barrier_done = 0, inactive_done = 0;
+  int        **base;
+  int         *loc;
+  task_t       tasks[NHDL];
+  armci_hdl_t  handles[NHDL], bar_handle, idle_handle;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Completion Callback Test:\n");
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, NHDL*N*sizeof(int));
+
+  ARMCI_Access_begin(base[rank]);
+  for (i = 0; i < NHDL*N; i++)
+    base[rank][i] = rank*NHDL*N + i;
+  ARMCI_Access_end(base[rank]);
+
+  loc  = ARMCI_Malloc_local(NHDL*N*sizeof(int));
+  peer = (rank + 1) % nranks;
+
+  for (i = 0; i < NHDL*N; i++)
+    loc[i] = -1;
+
+  ARMCI_Barrier();
+
+#ifdef USE_RMA_REQUESTS
+  for (h = 0; h < NHDL; h++) {
+    tasks[h].blk   = h;
+    tasks[h].stage = 0;
+    tasks[h].base  = base;
+    tasks[h].loc   = loc;
+    tasks[h].peer  = peer;
+
+    ARMCI_INIT_HANDLE(&handles[h]);
+    ARMCI_NbGet(base[peer] + h*N, loc + h*N, N/2*sizeof(int), peer, &handles[h]);
+    ARMCIX_Callback_hdl(&handles[h], get_done, &tasks[h]);
+  }
+
+  ARMCI_INIT_HANDLE(&idle_handle);
+  ARMCIX_Callback_hdl(&idle_handle, count_done, &inactive_done);
+
+  ARMCI_INIT_HANDLE(&bar_handle);
+  ARMCIX_Ibarrier(&bar_handle);
+  ARMCIX_Callback_hdl(&bar_handle, count_done, &barrier_done);
+
+  do {
+    ARMCIX_Progress();
+
+    for (h = 0, pending = 0; h < NHDL; h++)
+      pending += (tasks[h].stage < 2);
+    pending += !barrier_done + !inactive_done;
+  } while (pending > 0);
+
+  for (h = 0; h < NHDL; h++) {
+    if (tasks[h].stage != 2) {
+      printf("%d: Handle %d completed %d stages\n", rank, h, tasks[h].stage);
+      errors++;
+    }
+  }
+
+  if (barrier_done != 1 || inactive_done != 1) {
+    printf("%d: Barrier callback ran %d times, inactive %d times\n", rank, barrier_done, inactive_done);
+    errors++;
+  }
+
+  for (i = 0; i < NHDL*N; i++) {
+    if (loc[i] != peer*NHDL*N + i) {
+      if (errors < 10)
+        printf("%d: Validation failed at %d expected=%d actual=%d\n",
+               rank, i, peer*NHDL*N + i, loc[i]);
+      errors++;
+    }
+  }
+#else
+  /* Testing a handle would block without RMA requests, so callbacks are refused */
+  ARMCI_INIT_HANDLE(&idle_handle);
+
+  if (ARMCIX_Callback_hdl(&idle_handle, count_done, &inactive_done) == 0) {
+    printf("%d: Callback registered without RMA requests\n", rank);
+    errors++;
+  }
+#endif
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Barrier();
+
+  ARMCI_Free(base[rank]);
+  ARMCI_Free_local(loc);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,132 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NHDL 64
+#define N    64
+
+/* Completion callbacks with the progress thread enabled and ARMCI initialized
+ * below MPI_THREAD_MULTIPLE: callbacks are registered while the progress
+ * thread polls MPI, and they must only run from ARMCIX_Progress on the main
+ * thread. */
+
+static pthread_t main_thread;
+static int       ndone, nforeign;
+
+static void get_done(armci_hdl_t *handle, void *arg) {
+  if (!pthread_equal(pthread_self(), main_thread))
+    nforeign++;
+  ndone++;
+}
+
+int main(int argc, char **argv) {
+  int          rank, nranks, peer, h, i, provided, early, errors = 0;
+  int        **base;
+  int         *loc;
+  armci_hdl_t  handles[NHDL];
+
+  setenv("ARMCI_PROGRESS_THREAD", "1", 1);
+
+  /* The progress thread is only created when MPI provides MPI_THREAD_MULTIPLE */
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_MULTIPLE, &provided);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Completion Callback Progress Thread Test:\n");
+
+  if (rank == 0 && provided != MPI_THREAD_MULTIPLE)
+    printf("MPI_THREAD_MULTIPLE is not available, running without the progress thread\n");
+
+  main_thread = pthread_self();
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, NHDL*N*sizeof(int));
+
+  ARMCI_Access_begin(base[rank]);
+  for (i = 0; i < NHDL*N; i++)
+    base[rank][i] = rank*NHDL*N + i;
+  ARMCI_Access_end(base[rank]);
+
+  loc  = ARMCI_Malloc_local(NHDL*N*sizeof(int));
+  peer = (rank + 1) % nranks;
+
+  ARMCI_Barrier();
+
+#ifdef USE_RMA_REQUESTS
+  /* Enough registrations to grow the callback table several times */
+  for (h = 0; h < NHDL; h++) {
+    ARMCI_INIT_HANDLE(&handles[h]);
+    ARMCI_NbGet(base[peer] + h*N, loc + h*N, N*sizeof(int), peer, &handles[h]);
+    ARMCIX_Callback_hdl(&handles[h], get_done, NULL);
+  }
+
+  /* Give the progress thread time to (wrongly) run them */
+  usleep(10000);
+  early = ndone;
+
+  if (early != 0) {
+    printf("%d: %d callbacks ran before ARMCIX_Progress\n", rank, early);
+    errors++;
+  }
+
+  while (ndone < NHDL)
+    ARMCIX_Progress();
+
+  if (nforeign != 0) {
+    printf("%d: %d callbacks ran outside the main thread\n", rank, nforeign);
+    errors++;
+  }
+
+  for (i = 0; i < NHDL*N; i++) {
+    if (loc[i] != peer*NHDL*N + i) {
+      if (errors < 10)
+        printf("%d: Validation failed at %d expected=%d actual=%d\n",
+               rank, i, peer*NHDL*N + i, loc[i]);
+      errors++;
+    }
+  }
+#else
+  /* Testing a handle would block the progress thread without RMA requests,
+   * so callbacks are refused */
+  ARMCI_INIT_HANDLE(&handles[0]);
+  ARMCI_NbGet(base[peer], loc, N*sizeof(int), peer, &handles[0]);
+
+  if (ARMCIX_Callback_hdl(&handles[0], get_done, NULL) == 0) {
+    printf("%d: Callback registered without RMA requests\n", rank);
+    errors++;
+  }
+
+  ARMCI_Wait(&handles[0]);
+#endif
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Barrier();
+
+  ARMCI_Free(base[rank]);
+  ARMCI_Free_local(loc);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
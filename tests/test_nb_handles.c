@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NALLOC 3
+#define N      64
+
+/* Each handle carries operations to several allocations and targets; Wait and
+ * Test must complete all of them. */
+
+int main(int argc, char **argv) {
+  int          rank, nranks, a, i, t, errors = 0;
+  int        **bufs[NALLOC];
+  int         *loc, *get_buf;
+  armci_hdl_t  handle;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Nonblocking Handle Test:\n");
+
+  for (a = 0; a < NALLOC; a++) {
+    bufs[a] = malloc(nranks*sizeof(int*));
+    ARMCI_Malloc((void**) bufs[a], N*sizeof(int));
+  }
+
+  loc     = ARMCI_Malloc_local(N*sizeof(int));
+  get_buf = ARMCI_Malloc_local(NALLOC*nranks*N*sizeof(int));
+
+  for (i = 0; i < N; i++)
+    loc[i] = rank*1000 + i;
+
+  for (a = 0; a < NALLOC; a++) {
+    ARMCI_Access_begin(bufs[a][rank]);
+    for (i = 0; i < N; i++)
+      bufs[a][rank][i] = 0;
+    ARMCI_Access_end(bufs[a][rank]);
+  }
+
+  ARMCI_Barrier();
+
+  /* Put my data to every process in every allocation on one handle */
+  ARMCI_INIT_HANDLE(&handle);
+
+  for (a = 0; a < NALLOC; a++)
+    for (t = 0; t < nranks; t++)
+      ARMCI_NbPut(loc, bufs[a][t] + (rank % N), sizeof(int), t, &handle);
+
+  ARMCI_Wait(&handle);
+  ARMCI_AllFence();
+  ARMCI_Barrier();
+
+  /* Accumulate twice with an aggregate handle, completing it with Test */
+  ARMCI_INIT_HANDLE(&handle);
+  ARMCI_SET_AGGREGATE_HANDLE(&handle);
+
+  for (a = 0; a < NALLOC; a++) {
+    for (t = 0; t < nranks; t++) {
+      int one = 1;
+      ARMCI_NbAcc(ARMCI_ACC_INT, &one, loc, bufs[a][t] + N/2, (N/2)*sizeof(int), t, &handle);
+      ARMCI_NbAcc(ARMCI_ACC_INT, &one, loc, bufs[a][t] + N/2, (N/2)*sizeof(int), t, &handle);
+    }
+  }
+
+  while (ARMCI_Test(&handle))
+    ;
+
+  ARMCI_UNSET_AGGREGATE_HANDLE(&handle);
+  ARMCI_AllFence();
+  ARMCI_Barrier();
+
+  /* Read everything back on one handle */
+  ARMCI_INIT_HANDLE(&handle);
+
+  for (a = 0; a < NALLOC; a++)
+    for (t = 0; t < nranks; t++)
+      ARMCI_NbGet(bufs[a][t], get_buf + (a*nranks + t)*N, N*sizeof(int), t, &handle);
+
+  ARMCI_Wait(&handle);
+
+  for (a = 0; a < NALLOC; a++) {
+    for (t = 0; t < nranks; t++) {
+      const int *b = get_buf + (a*nranks + t)*N;
+
+      /* Slot p of the first half holds process p's first element */
+      for (i = 0; i < nranks && i < N/2; i++) {
+        if (b[i] != i*1000) {
+          printf("%d: Put validation failed alloc %d target %d at %d expected=%d actual=%d\n",
+                 rank, a, t, i, i*1000, b[i]);
+          errors++;
+        }
+      }
+
+      for (i = N/2; i < N; i++) {
+        int expected = 0, p;
+
+        for (p = 0; p < nranks; p++)
+          expected += 2*(p*1000 + i - N/2);
+
+        if (i < nranks)
+          expected += i*1000;
+
+        if (b[i] != expected) {
+          printf("%d: Acc validation failed alloc %d target %d at %d expected=%d actual=%d\n",
+                 rank, a, t, i, expected, b[i]);
+          errors++;
+        }
+      }
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  for (a = 0; a < NALLOC; a++) {
+    ARMCI_Free(bufs[a][rank]);
+    free(bufs[a]);
+  }
+  ARMCI_Free_local(loc);
+  ARMCI_Free_local(get_buf);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,130 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NTASK 200
+
+/* Nonblocking atomics: processes claim task ids from a shared counter,
+ * prefetching the next id while the current task runs, and every id must be
+ * claimed exactly once.  Then swaps to every process share one handle. */
+
+int main(int argc, char **argv) {
+  int          rank, nranks, i, p, errors = 0;
+  long       **counter;
+  int        **slot;
+  long         ids[2];
+  int         *claims, *swapped;
+  armci_hdl_t  handle;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Nonblocking RMW Test:\n");
+
+  counter = malloc(nranks*sizeof(long*));
+  ARMCI_Malloc((void**) counter, sizeof(long));
+
+  slot = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) slot, nranks*sizeof(int));
+
+  ARMCI_Access_begin(counter[rank]);
+  *counter[rank] = 0;
+  ARMCI_Access_end(counter[rank]);
+
+  ARMCI_Access_begin(slot[rank]);
+  for (p = 0; p < nranks; p++)
+    slot[rank][p] = -1;
+  ARMCI_Access_end(slot[rank]);
+
+  claims  = calloc(NTASK, sizeof(int));
+  swapped = malloc(nranks*sizeof(int));
+
+  ARMCI_Barrier();
+
+  /* Claim tasks from the counter on process 0, prefetching the next id */
+  ARMCI_INIT_HANDLE(&handle);
+  ARMCIX_NbRmw(ARMCI_FETCH_AND_ADD_LONG, &ids[0], counter[0], 1, 0, &handle);
+
+  for (i = 0; ; i = !i) {
+    ARMCI_Wait(&handle);
+    if (ids[i] >= NTASK) break;
+
+    ARMCI_INIT_HANDLE(&handle);
+    ARMCIX_NbRmw(ARMCI_FETCH_AND_ADD_LONG, &ids[!i], counter[0], 1, 0, &handle);
+
+    claims[ids[i]]++;
+  }
+
+  armci_msg_igop(claims, NTASK, "+");
+
+  for (i = 0; i < NTASK; i++) {
+    if (claims[i] != 1) {
+      printf("%d: Task %d was claimed %d times\n", rank, i, claims[i]);
+      errors++;
+    }
+  }
+
+  /* Swap rank into this process's slot everywhere, then rank+nranks */
+  for (i = 0; i < 2; i++) {
+    ARMCI_INIT_HANDLE(&handle);
+
+    for (p = 0; p < nranks; p++) {
+      swapped[p] = rank + i*nranks;
+      ARMCIX_NbRmw(ARMCI_SWAP, &swapped[p], &slot[p][rank], 0, p, &handle);
+    }
+
+    ARMCI_Wait(&handle);
+    ARMCI_AllFence();
+
+    for (p = 0; p < nranks; p++) {
+      const int expected = (i == 0) ? -1 : rank;
+
+      if (swapped[p] != expected) {
+        printf("%d: Swap %d with %d returned %d, expected %d\n", rank, i, p, swapped[p], expected);
+        errors++;
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(slot[rank]);
+  for (p = 0; p < nranks; p++) {
+    if (slot[rank][p] != p + nranks) {
+      printf("%d: Slot %d is %d, expected %d\n", rank, p, slot[rank][p], p + nranks);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(slot[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Free(counter[rank]);
+  ARMCI_Free(slot[rank]);
+  free(counter);
+  free(slot);
+  free(claims);
+  free(swapped);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
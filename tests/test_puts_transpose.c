@@ -0,0 +1,133 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NX 7
+#define NY 5
+#define NZ 3
+#define NPERM 3
+
+/* Remote dimension of each local dimension */
+static int perms[NPERM][3] = { { 2, 0, 1 }, { 0, 2, 1 }, { 1, 0, 2 } };
+
+static double value(int rank, int x, int y, int z) {
+  return rank*1000000.0 + z*10000.0 + y*100.0 + x;
+}
+
+int main(int argc, char **argv) {
+  int     rank, nranks, peer, p, t, x, y, z, errors = 0;
+  double  **buffer, *src_buf, *dst_buf;
+  int     count[3], src_stride[2], dst_stride[2], dims[3], idx[3];
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Strided Transpose Test:\n");
+
+  buffer = (double **) malloc(sizeof(double *) * nranks);
+  ARMCI_Malloc((void **) buffer, NX*NY*NZ*sizeof(double));
+  src_buf = ARMCI_Malloc_local(NX*NY*NZ*sizeof(double));
+  dst_buf = ARMCI_Malloc_local(NX*NY*NZ*sizeof(double));
+
+  /* Local array is [NZ][NY][NX] */
+  for (z = 0; z < NZ; z++)
+    for (y = 0; y < NY; y++)
+      for (x = 0; x < NX; x++)
+        src_buf[(z*NY + y)*NX + x] = value(rank, x, y, z);
+
+  count[0]      = NX*sizeof(double);
+  count[1]      = NY;
+  count[2]      = NZ;
+  src_stride[0] = NX*sizeof(double);
+  src_stride[1] = NX*NY*sizeof(double);
+
+  /* Test both a remote peer and the local fallback path */
+  for (t = 0; t < 2; t++) {
+    peer = (t == 0) ? (rank+1) % nranks : rank;
+
+    for (p = 0; p < NPERM; p++) {
+      int *perm = perms[p];
+
+      /* Remote extent of each dimension */
+      dims[perm[0]] = NX;
+      dims[perm[1]] = NY;
+      dims[perm[2]] = NZ;
+
+      dst_stride[0] = dims[0]*sizeof(double);
+      dst_stride[1] = dims[0]*dims[1]*sizeof(double);
+
+      ARMCI_Barrier();
+
+      ARMCIX_PutS_transpose(src_buf, src_stride, buffer[peer], dst_stride, count, 2, perm,
+                            sizeof(double), peer);
+
+      ARMCI_Barrier();
+
+      /* Check the transposed data that landed in my buffer */
+      ARMCI_Access_begin(buffer[rank]);
+      for (z = 0; z < NZ; z++)
+        for (y = 0; y < NY; y++)
+          for (x = 0; x < NX; x++) {
+            const int    src_rank = (t == 0) ? (rank+nranks-1) % nranks : rank;
+            const double expected = value(src_rank, x, y, z);
+            double       actual;
+
+            idx[perm[0]] = x;
+            idx[perm[1]] = y;
+            idx[perm[2]] = z;
+
+            actual = buffer[rank][(idx[2]*dims[1] + idx[1])*dims[0] + idx[0]];
+
+            if (actual != expected) {
+              printf("%d: Put validation failed perm %d at [%d, %d, %d] expected=%f actual=%f\n",
+                     rank, p, z, y, x, expected, actual);
+              errors++;
+            }
+          }
+      ARMCI_Access_end(buffer[rank]);
+
+      ARMCI_Barrier();
+
+      /* Read it back, undoing the transpose */
+      ARMCIX_GetS_transpose(buffer[peer], dst_stride, dst_buf, src_stride, count, 2, perm,
+                            sizeof(double), peer);
+
+      for (x = 0; x < NX*NY*NZ; x++) {
+        if (dst_buf[x] != src_buf[x]) {
+          printf("%d: Get validation failed perm %d at %d expected=%f actual=%f\n",
+                 rank, p, x, src_buf[x], dst_buf[x]);
+          errors++;
+        }
+      }
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Free(buffer[rank]);
+  ARMCI_Free_local(src_buf);
+  ARMCI_Free_local(dst_buf);
+  free(buffer);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NSEG  64
+#define SEGLEN 8
+#define NWIN  3
+
+/* I/O vectors whose remote segments are interleaved across several
+ * allocations. */
+
+int main(int argc, char **argv) {
+  int     i, j, w, rank, nranks, peer, errors = 0;
+  double **buffer[NWIN], *src_buf, *dst_buf;
+  double  one = 1.0;
+  armci_giov_t iov;
+
+  /* Allocation checks must be enabled to detect the multi-window case */
+  setenv("ARMCI_IOV_CHECKS", "1", 1);
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Multi-Window I/O Vector Test:\n");
+
+  peer = (rank+1) % nranks;
+
+  for (w = 0; w < NWIN; w++) {
+    buffer[w] = malloc(sizeof(double *) * nranks);
+    ARMCI_Malloc((void **) buffer[w], NSEG*SEGLEN*sizeof(double));
+  }
+
+  src_buf = ARMCI_Malloc_local(NSEG*SEGLEN*sizeof(double));
+  dst_buf = ARMCI_Malloc_local(NSEG*SEGLEN*sizeof(double));
+
+  for (i = 0; i < NSEG*SEGLEN; i++)
+    src_buf[i] = rank*10000.0 + i;
+
+  /* Segment i goes to window i % NWIN, row i / NWIN */
+  iov.bytes          = SEGLEN*sizeof(double);
+  iov.ptr_array_len  = NSEG;
+  iov.src_ptr_array  = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array  = malloc(NSEG*sizeof(void*));
+
+  for (i = 0; i < NSEG; i++) {
+    iov.src_ptr_array[i] = &src_buf[i*SEGLEN];
+    iov.dst_ptr_array[i] = &buffer[i % NWIN][peer][(i / NWIN)*SEGLEN];
+  }
+
+  ARMCI_Barrier();
+  ARMCI_PutV(&iov, 1, peer);
+  ARMCI_Barrier();
+
+  /* Accumulate 1.0 into every element */
+  for (i = 0; i < NSEG*SEGLEN; i++)
+    dst_buf[i] = 1.0;
+
+  for (i = 0; i < NSEG; i++)
+    iov.src_ptr_array[i] = &dst_buf[i*SEGLEN];
+
+  ARMCI_AccV(ARMCI_ACC_DBL, &one, &iov, 1, peer);
+  ARMCI_Barrier();
+
+  /* Read the data back through the same vector */
+  for (i = 0; i < NSEG; i++) {
+    void *tmp = iov.src_ptr_array[i];
+    iov.src_ptr_array[i] = iov.dst_ptr_array[i];
+    iov.dst_ptr_array[i] = tmp;
+  }
+
+  for (i = 0; i < NSEG*SEGLEN; i++)
+    dst_buf[i] = -1.0;
+
+  ARMCI_GetV(&iov, 1, peer);
+
+  for (i = 0; i < NSEG; i++) {
+    for (j = 0; j < SEGLEN; j++) {
+      const double expected = rank*10000.0 + i*SEGLEN + j + 1.0;
+      const double actual   = dst_buf[i*SEGLEN + j];
+
+      if (actual != expected) {
+        printf("%d: Validation failed at segment %d [%d] expected=%f actual=%f\n",
+               rank, i, j, expected, actual);
+        errors++;
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  armci_msg_igop(&errors, 1, "+");
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+
+  for (w = 0; w < NWIN; w++) {
+    ARMCI_Free(buffer[w][rank]);
+    free(buffer[w]);
+  }
+
+  ARMCI_Free_local(src_buf);
+  ARMCI_Free_local(dst_buf);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+
+#define NSEG   2000
+#define SEGLEN 3
+
+/* I/O vectors whose local buffers are a mix of private memory and memory in
+ * an ARMCI allocation, which has to be staged through private space. */
+
+int main(int argc, char **argv) {
+  int     i, j, rank, nranks, peer, errors = 0;
+  double **remote, **shared, *private;
+  double  two = 2.0;
+  armci_giov_t iov;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI I/O Vector Shared Buffer Test:\n");
+
+  peer = (rank+1) % nranks;
+
+  remote = malloc(sizeof(double *) * nranks);
+  shared = malloc(sizeof(double *) * nranks);
+  ARMCI_Malloc((void **) remote, NSEG*SEGLEN*sizeof(double));
+  ARMCI_Malloc((void **) shared, NSEG*SEGLEN*sizeof(double));
+  private = malloc(NSEG*SEGLEN*sizeof(double));
+
+  iov.bytes         = SEGLEN*sizeof(double);
+  iov.ptr_array_len = NSEG;
+  iov.src_ptr_array = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array = malloc(NSEG*sizeof(void*));
+
+  ARMCI_Access_begin(shared[rank]);
+  for (i = 0; i < NSEG*SEGLEN; i++) {
+    shared[rank][i] = rank*1000000.0 + i;
+    private[i]      = rank*1000000.0 + i;
+  }
+  ARMCI_Access_end(shared[rank]);
+
+  /* Two out of three segments come from the shared buffer; remote segments
+   * are scattered. */
+  for (i = 0; i < NSEG; i++) {
+    iov.src_ptr_array[i] = (i % 3) ? (void*) &shared[rank][i*SEGLEN] : (void*) &private[i*SEGLEN];
+    iov.dst_ptr_array[i] = &remote[peer][((i*7) % NSEG)*SEGLEN];
+  }
+
+  ARMCI_Barrier();
+
+  /* Put, then accumulate twice the source on top: remote = 3*src */
+  ARMCI_PutV(&iov, 1, peer);
+  ARMCI_AccV(ARMCI_ACC_DBL, &two, &iov, 1, peer);
+
+  ARMCI_Barrier();
+
+  /* Get the data back into the same mix of local buffers */
+  for (i = 0; i < NSEG; i++) {
+    void *tmp = iov.src_ptr_array[i];
+    iov.src_ptr_array[i] = iov.dst_ptr_array[i];
+    iov.dst_ptr_array[i] = tmp;
+  }
+
+  ARMCI_Access_begin(shared[rank]);
+  for (i = 0; i < NSEG*SEGLEN; i++) {
+    shared[rank][i] = 0.0;
+    private[i]      = 0.0;
+  }
+  ARMCI_Access_end(shared[rank]);
+
+  ARMCI_GetV(&iov, 1, peer);
+
+  ARMCI_Access_begin(shared[rank]);
+  for (i = 0; i < NSEG; i++) {
+    double *buf = (i % 3) ? &shared[rank][i*SEGLEN] : &private[i*SEGLEN];
+
+    for (j = 0; j < SEGLEN; j++) {
+      const double expected = 3.0*(rank*1000000.0 + i*SEGLEN + j);
+
+      if (buf[j] != expected) {
+        printf("%d: Validation failed at segment %d [%d] expected=%f actual=%f\n",
+               rank, i, j, expected, buf[j]);
+        errors++;
+      }
+    }
+  }
+  ARMCI_Access_end(shared[rank]);
+
+  ARMCI_Barrier();
+
+  armci_msg_igop(&errors, 1, "+");
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+
+  ARMCI_Free(remote[rank]);
+  ARMCI_Free(shared[rank]);
+  free(remote);
+  free(shared);
+  free(private);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NSEG   40
+#define MAXLEN 7
+#define NELEM  (NSEG*(MAXLEN+1))
+
+/* Segment i is (i % MAXLEN) + 1 elements long and starts at i*(MAXLEN+1) in
+ * the remote buffer, leaving a gap after each segment.  Segments are packed in
+ * the local buffer. */
+
+static int seg_len(int i) {
+  return (i % MAXLEN) + 1;
+}
+
+int main(int argc, char **argv) {
+  int     i, j, rank, nranks, peer, off, errors = 0;
+  double **buffer, *src_buf;
+  double  two = 2.0;
+  int     bytes[NSEG];
+  armcix_giovl_t iov;
+  armci_hdl_t    handle;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Variable-Length I/O Vector Test:\n");
+
+  peer = (rank+1) % nranks;
+
+  buffer = malloc(sizeof(double *) * nranks);
+  ARMCI_Malloc((void **) buffer, NELEM*sizeof(double));
+
+  src_buf = ARMCI_Malloc_local(NELEM*sizeof(double));
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = 0; i < NELEM; i++)
+    buffer[rank][i] = -1.0;
+  ARMCI_Access_end(buffer[rank]);
+
+  for (i = 0; i < NELEM; i++)
+    src_buf[i] = rank*10000.0 + i;
+
+  iov.ptr_array_len = NSEG;
+  iov.bytes_array   = bytes;
+  iov.src_ptr_array = malloc(NSEG*sizeof(void*));
+  iov.dst_ptr_array = malloc(NSEG*sizeof(void*));
+
+  for (i = off = 0; i < NSEG; i++) {
+    bytes[i]             = seg_len(i)*sizeof(double);
+    iov.src_ptr_array[i] = &src_buf[off];
+    iov.dst_ptr_array[i] = &buffer[peer][i*(MAXLEN+1)];
+    off += seg_len(i);
+  }
+
+  ARMCI_Barrier();
+
+  /* Put, then accumulate twice the source on top: remote = 3*src */
+  ARMCI_INIT_HANDLE(&handle);
+  ARMCIX_NbPutVL(&iov, 1, peer, &handle);
+  ARMCI_Wait(&handle);
+  ARMCIX_AccVL(ARMCI_ACC_DBL, &two, &iov, 1, peer);
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (i = off = 0; i < NSEG; i++) {
+    for (j = 0; j < MAXLEN+1; j++) {
+      const double expected = (j < seg_len(i)) ? 3.0*(((rank+nranks-1) % nranks)*10000.0 + off + j) : -1.0;
+      const double actual   = buffer[rank][i*(MAXLEN+1) + j];
+
+      if (actual != expected) {
+        printf("%d: Put/Acc validation failed at segment %d [%d] expected=%f actual=%f\n",
+               rank, i, j, expected, actual);
+        errors++;
+      }
+    }
+    off += seg_len(i);
+  }
+  ARMCI_Access_end(buffer[rank]);
+
+  ARMCI_Barrier();
+
+  /* Read the segments back, blocking and nonblocking */
+  for (i = 0; i < NSEG; i++) {
+    void *tmp = iov.src_ptr_array[i];
+    iov.src_ptr_array[i] = iov.dst_ptr_array[i];
+    iov.dst_ptr_array[i] = tmp;
+  }
+
+  for (j = 0; j < 2; j++) {
+    for (i = 0; i < NELEM; i++)
+      src_buf[i] = 0.0;
+
+    if (j == 0) {
+      ARMCIX_GetVL(&iov, 1, peer);
+    } else {
+      ARMCI_INIT_HANDLE(&handle);
+      ARMCIX_NbGetVL(&iov, 1, peer, &handle);
+      ARMCI_Wait(&handle);
+    }
+
+    for (i = off = 0; i < NSEG; off += seg_len(i), i++) {
+      int k;
+
+      for (k = 0; k < seg_len(i); k++) {
+        const double expected = 3.0*(rank*10000.0 + off + k);
+
+        if (src_buf[off + k] != expected) {
+          printf("%d: Get (%s) validation failed at segment %d [%d] expected=%f actual=%f\n",
+                 rank, j ? "nonblocking" : "blocking", i, k, expected, src_buf[off + k]);
+          errors++;
+        }
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  armci_msg_igop(&errors, 1, "+");
+
+  free(iov.src_ptr_array);
+  free(iov.dst_ptr_array);
+
+  ARMCI_Free(buffer[rank]);
+  ARMCI_Free_local(src_buf);
+  free(buffer);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NINC 50
+
+/* Open MPI 4's shared memory transport crashes on 8-byte compare-and-swap, so
+ * the counter falls back to int there */
+#if defined(OPEN_MPI) && defined(OMPI_MAJOR_VERSION) && (OMPI_MAJOR_VERSION == 4)
+typedef int  cas_t;
+#define CAS_TYPE ARMCI_ACC_INT
+#else
+typedef long cas_t;
+#define CAS_TYPE ARMCI_ACC_LNG
+#endif
+
+/* Extended atomics: every process increments a counter on every process
+ * with a compare-and-swap loop, adds to a double, and applies min, max and
+ * bitwise operations to ints. */
+
+enum { I_MIN, I_MAX, I_BAND, I_BOR, I_BXOR, NINT };
+
+int main(int argc, char **argv) {
+  int          rank, nranks, i, p, errors = 0;
+  cas_t      **lcnt;
+  double     **dsum;
+  int        **ival;
+  int          band, bor, bxor, iold, iarg;
+  cas_t        lold, lnew, lgot;
+  double       dold, dinc = 0.5;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Extended RMW Test:\n");
+
+  lcnt = malloc(nranks*sizeof(cas_t*));
+  dsum = malloc(nranks*sizeof(double*));
+  ival = malloc(nranks*sizeof(int*));
+
+  ARMCI_Malloc((void**) lcnt, sizeof(cas_t));
+  ARMCI_Malloc((void**) dsum, sizeof(double));
+  ARMCI_Malloc((void**) ival, NINT*sizeof(int));
+
+  for (p = 0, band = -1, bor = 0, bxor = 0; p < nranks; p++) {
+    band &= ~(1 << (p % 30));
+    bor  |=   1 << (p % 30);
+    bxor ^=   1 << (p % 30);
+  }
+
+  ARMCI_Access_begin(lcnt[rank]);
+  *lcnt[rank] = 0;
+  ARMCI_Access_end(lcnt[rank]);
+
+  ARMCI_Access_begin(dsum[rank]);
+  *dsum[rank] = 0.0;
+  ARMCI_Access_end(dsum[rank]);
+
+  ARMCI_Access_begin(ival[rank]);
+  ival[rank][I_MIN]  = 1 << 30;
+  ival[rank][I_MAX]  = -1;
+  ival[rank][I_BAND] = -1;
+  ival[rank][I_BOR]  = 0;
+  ival[rank][I_BXOR] = 0;
+  ARMCI_Access_end(ival[rank]);
+
+  ARMCI_Barrier();
+
+  for (p = 0; p < nranks; p++) {
+    /* Compare-and-swap increment, starting from a stale guess */
+    for (i = 0, lold = -1; i < NINC; i++) {
+      for (;;) {
+        lnew = lold + 1;
+        ARMCIX_Rmw_cas(CAS_TYPE, &lgot, lcnt[p], &lold, &lnew, p);
+        if (lgot == lold) break;
+        lold = lgot;
+      }
+      lold = lnew;
+    }
+
+    for (i = 0; i < NINC; i++)
+      ARMCIX_Rmw_fetch_op(ARMCIX_RMW_SUM, ARMCI_ACC_DBL, &dold, dsum[p], &dinc, p);
+
+    iarg = rank + 1;
+    ARMCIX_Rmw_fetch_op(ARMCIX_RMW_MIN, ARMCI_ACC_INT, &iold, &ival[p][I_MIN], &iarg, p);
+    ARMCIX_Rmw_fetch_op(ARMCIX_RMW_MAX, ARMCI_ACC_INT, &iold, &ival[p][I_MAX], &iarg, p);
+
+    iarg = ~(1 << (rank % 30));
+    ARMCIX_Rmw_fetch_op(ARMCIX_RMW_BAND, ARMCI_ACC_INT, &iold, &ival[p][I_BAND], &iarg, p);
+
+    iarg = 1 << (rank % 30);
+    ARMCIX_Rmw_fetch_op(ARMCIX_RMW_BOR, ARMCI_ACC_INT, &iold, &ival[p][I_BOR], &iarg, p);
+    ARMCIX_Rmw_fetch_op(ARMCIX_RMW_BXOR, ARMCI_ACC_INT, &iold, &ival[p][I_BXOR], &iarg, p);
+  }
+
+  /* A failing compare-and-swap leaves the value alone */
+  lold = -1;
+  lnew = 12345;
+  ARMCIX_Rmw_cas(CAS_TYPE, &lgot, lcnt[(rank + 1) % nranks], &lold, &lnew, (rank + 1) % nranks);
+  if (lgot == lold) {
+    printf("%d: Compare-and-swap succeeded with a bad compare value\n", rank);
+    errors++;
+  }
+
+  ARMCI_AllFence();
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(lcnt[rank]);
+  if (*lcnt[rank] != (cas_t) NINC*nranks) {
+    printf("%d: Counter is %ld, expected %ld\n", rank, (long) *lcnt[rank], (long) NINC*nranks);
+    errors++;
+  }
+  ARMCI_Access_end(lcnt[rank]);
+
+  ARMCI_Access_begin(dsum[rank]);
+  if (*dsum[rank] != dinc*NINC*nranks) {
+    printf("%d: Sum is %f, expected %f\n", rank, *dsum[rank], dinc*NINC*nranks);
+    errors++;
+  }
+  ARMCI_Access_end(dsum[rank]);
+
+  ARMCI_Access_begin(ival[rank]);
+  if (ival[rank][I_MIN] != 1 || ival[rank][I_MAX] != nranks) {
+    printf("%d: Min/max are %d/%d, expected 1/%d\n", rank, ival[rank][I_MIN], ival[rank][I_MAX], nranks);
+    errors++;
+  }
+  if (ival[rank][I_BAND] != band || ival[rank][I_BOR] != bor || ival[rank][I_BXOR] != bxor) {
+    printf("%d: Band/bor/bxor are %x/%x/%x, expected %x/%x/%x\n", rank, ival[rank][I_BAND],
+           ival[rank][I_BOR], ival[rank][I_BXOR], band, bor, bxor);
+    errors++;
+  }
+  ARMCI_Access_end(ival[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Free(lcnt[rank]);
+  ARMCI_Free(dsum[rank]);
+  ARMCI_Free(ival[rank]);
+  free(lcnt);
+  free(dsum);
+  free(ival);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NCNT  4
+#define NITER 50
+
+/* Batched atomics: every process repeatedly adds to every counter of two
+ * allocations on every process in one ARMCIX_Rmw_vec call, hitting each
+ * counter twice per batch, then swaps values into its own slot on every
+ * process. */
+
+int main(int argc, char **argv) {
+  int          rank, nranks, i, j, k, p, n, errors = 0;
+  int        **cnt[2];
+  long       **slot;
+  void       **ploc, **prem;
+  int         *vals, *procs, *fetched;
+  long        *lfetched;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Batched RMW Test:\n");
+
+  for (i = 0; i < 2; i++) {
+    cnt[i] = malloc(nranks*sizeof(int*));
+    ARMCI_Malloc((void**) cnt[i], NCNT*sizeof(int));
+
+    ARMCI_Access_begin(cnt[i][rank]);
+    for (k = 0; k < NCNT; k++)
+      cnt[i][rank][k] = 0;
+    ARMCI_Access_end(cnt[i][rank]);
+  }
+
+  slot = malloc(nranks*sizeof(long*));
+  ARMCI_Malloc((void**) slot, nranks*sizeof(long));
+
+  ARMCI_Access_begin(slot[rank]);
+  for (p = 0; p < nranks; p++)
+    slot[rank][p] = 0;
+  ARMCI_Access_end(slot[rank]);
+
+  n        = 4*nranks*NCNT;
+  ploc     = malloc(n*sizeof(void*));
+  prem     = malloc(n*sizeof(void*));
+  vals     = malloc(n*sizeof(int));
+  procs    = malloc(n*sizeof(int));
+  fetched  = malloc(n*sizeof(int));
+  lfetched = malloc(nranks*sizeof(long));
+
+  ARMCI_Barrier();
+
+  /* Fetch-and-add: counter k of allocation i on process p is incremented by
+   * 1 and by 2 in every batch */
+  for (j = 0; j < NITER; j++) {
+    int m = 0;
+
+    for (p = 0; p < nranks; p++) {
+      for (i = 0; i < 2; i++) {
+        for (k = 0; k < NCNT; k++) {
+          int inc;
+
+          for (inc = 1; inc <= 2; inc++) {
+            ploc[m]  = &fetched[m];
+            prem[m]  = &cnt[i][(rank + p) % nranks][k];
+            vals[m]  = inc;
+            procs[m] = (rank + p) % nranks;
+            m++;
+          }
+        }
+      }
+    }
+
+    ARMCIX_Rmw_vec(ARMCI_FETCH_AND_ADD, m, ploc, prem, vals, procs);
+
+    for (i = 0; i < m; i++) {
+      if (fetched[i] < 0 || fetched[i] > 3*nranks*NITER - vals[i]) {
+        printf("%d: Fetched bad value %d\n", rank, fetched[i]);
+        errors++;
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < 2; i++) {
+    ARMCI_Access_begin(cnt[i][rank]);
+    for (k = 0; k < NCNT; k++) {
+      if (cnt[i][rank][k] != 3*nranks*NITER) {
+        printf("%d: Counter %d of allocation %d is %d, expected %d\n",
+               rank, k, i, cnt[i][rank][k], 3*nranks*NITER);
+        errors++;
+      }
+    }
+    ARMCI_Access_end(cnt[i][rank]);
+  }
+
+  /* Swap: rank+1 and then rank+2 into this process's slot everywhere */
+  for (j = 1; j <= 2; j++) {
+    for (p = 0; p < nranks; p++) {
+      lfetched[p] = rank + j;
+      ploc[p]     = &lfetched[p];
+      prem[p]     = &slot[p][rank];
+      procs[p]    = p;
+    }
+
+    ARMCIX_Rmw_vec(ARMCI_SWAP_LONG, nranks, ploc, prem, NULL, procs);
+
+    for (p = 0; p < nranks; p++) {
+      const long expected = (j == 1) ? 0 : rank + 1;
+
+      if (lfetched[p] != expected) {
+        printf("%d: Swap %d with %d fetched %ld, expected %ld\n", rank, j, p, lfetched[p], expected);
+        errors++;
+      }
+    }
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(slot[rank]);
+  for (p = 0; p < nranks; p++) {
+    if (slot[rank][p] != p + 2) {
+      printf("%d: Slot %d is %ld, expected %d\n", rank, p, slot[rank][p], p + 2);
+      errors++;
+    }
+  }
+  ARMCI_Access_end(slot[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  for (i = 0; i < 2; i++) {
+    ARMCI_Free(cnt[i][rank]);
+    free(cnt[i]);
+  }
+  ARMCI_Free(slot[rank]);
+  free(slot);
+  free(ploc);
+  free(prem);
+  free(vals);
+  free(procs);
+  free(fetched);
+  free(lfetched);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
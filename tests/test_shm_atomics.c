@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NINC 100
+
+/* Shared memory atomics: counters allocated with the "shm_atomics" device are
+ * only targeted by processes on the same node.  Every process increments the
+ * counters of its node peers through ARMCI_Rmw, ARMCIX_Rmw_vec, ARMCIX_NbRmw
+ * and a compare-and-swap loop, then the totals are read back with ARMCI_Get.
+ * Waiting on the nonblocking ones must not warn about an inactive handle, so
+ * stderr is captured around them. */
+
+enum { C_RMW, C_VEC, C_NB, C_CAS, NCTR };
+
+int main(int argc, char **argv) {
+  int          rank, nranks, node_size, i, c, p, errors = 0;
+  int        **ctr;
+  int         *peers, *fetched, *vals;
+  void       **ploc, **prem;
+  int          old, iold, inew, iexp, got[NCTR], saved_stderr;
+  FILE        *nb_log;
+  MPI_Comm     node_comm;
+  MPI_Group    node_group, world_group;
+  armci_hdl_t  handle;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Shared Memory Atomics Test:\n");
+
+  /* Find the processes on this node */
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, rank, MPI_INFO_NULL, &node_comm);
+  MPI_Comm_size(node_comm, &node_size);
+  MPI_Comm_group(node_comm, &node_group);
+  MPI_Comm_group(MPI_COMM_WORLD, &world_group);
+
+  peers = malloc(node_size*sizeof(int));
+  for (p = 0; p < node_size; p++)
+    MPI_Group_translate_ranks(node_group, 1, &p, world_group, &peers[p]);
+
+  ctr = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc_memdev((void**) ctr, NCTR*sizeof(int), "shm_atomics");
+
+  ARMCI_Access_begin(ctr[rank]);
+  for (c = 0; c < NCTR; c++)
+    ctr[rank][c] = 0;
+  ARMCI_Access_end(ctr[rank]);
+
+  fetched = malloc(node_size*sizeof(int));
+  vals    = malloc(node_size*sizeof(int));
+  ploc    = malloc(node_size*sizeof(void*));
+  prem    = malloc(node_size*sizeof(void*));
+
+  nb_log       = tmpfile();
+  saved_stderr = dup(fileno(stderr));
+
+  ARMCI_Barrier();
+
+  for (i = 0; i < NINC; i++) {
+    for (p = 0; p < node_size; p++) {
+      ARMCI_Rmw(ARMCI_FETCH_AND_ADD, &old, &ctr[peers[p]][C_RMW], 1, peers[p]);
+
+      if (old < 0 || old >= NINC*node_size) {
+        printf("%d: Fetched bad value %d\n", rank, old);
+        errors++;
+      }
+
+      ploc[p] = &fetched[p];
+      prem[p] = &ctr[peers[p]][C_VEC];
+      vals[p] = 1;
+    }
+
+    ARMCIX_Rmw_vec(ARMCI_FETCH_AND_ADD, node_size, ploc, prem, vals, peers);
+
+    fflush(stderr);
+    dup2(fileno(nb_log), fileno(stderr));
+
+    ARMCI_INIT_HANDLE(&handle);
+    for (p = 0; p < node_size; p++)
+      ARMCIX_NbRmw(ARMCI_FETCH_AND_ADD, &fetched[p], &ctr[peers[p]][C_NB], 1, peers[p], &handle);
+    ARMCI_Wait(&handle);
+
+    fflush(stderr);
+    dup2(saved_stderr, fileno(stderr));
+
+    for (p = 0; p < node_size; p++) {
+      for (iold = 0; ; iold = iexp) {
+        inew = iold + 1;
+        ARMCIX_Rmw_cas(ARMCI_ACC_INT, &iexp, &ctr[peers[p]][C_CAS], &iold, &inew, peers[p]);
+        if (iexp == iold) break;
+      }
+    }
+  }
+
+  if (lseek(fileno(nb_log), 0, SEEK_END) > 0) {
+    printf("%d: Nonblocking atomics printed warnings\n", rank);
+    errors++;
+  }
+
+  close(saved_stderr);
+  fclose(nb_log);
+
+  ARMCI_Barrier();
+
+  ARMCI_Get(ctr[rank], got, NCTR*sizeof(int), rank);
+
+  for (c = 0; c < NCTR; c++) {
+    if (got[c] != NINC*node_size) {
+      printf("%d: Counter %d is %d, expected %d\n", rank, c, got[c], NINC*node_size);
+      errors++;
+    }
+  }
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Free_memdev(ctr[rank]);
+  free(ctr);
+  free(peers);
+  free(fetched);
+  free(vals);
+  free(ploc);
+  free(prem);
+
+  MPI_Group_free(&node_group);
+  MPI_Group_free(&world_group);
+  MPI_Comm_free(&node_comm);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,144 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define XDIM 16
+#define YDIM 12
+#define PX   5   /* Patch columns */
+#define PY   4   /* Patch rows    */
+
+/* Every rank reads, writes and accumulates a PY x PX patch of the XDIM x YDIM
+ * array on every rank with a single multi-target call. */
+
+static double value(int rank, int x, int y) {
+  return rank*1000.0 + y*XDIM + x;
+}
+
+int main(int argc, char **argv) {
+  int     i, x, y, p, rank, nranks, errors = 0;
+  double **buffer, *local;
+  double  two = 2.0;
+  int     count[2], rem_stride[1], loc_stride[1];
+  armcix_strided_desc_t *desc;
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Multi-Target Strided Test:\n");
+
+  buffer = malloc(sizeof(double *) * nranks);
+  ARMCI_Malloc((void **) buffer, XDIM*YDIM*sizeof(double));
+
+  local = ARMCI_Malloc_local(nranks*PX*PY*sizeof(double));
+  desc  = malloc(nranks*sizeof(armcix_strided_desc_t));
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (y = 0; y < YDIM; y++)
+    for (x = 0; x < XDIM; x++)
+      buffer[rank][y*XDIM + x] = value(rank, x, y);
+  ARMCI_Access_end(buffer[rank]);
+
+  count[0]      = PX*sizeof(double);
+  count[1]      = PY;
+  rem_stride[0] = XDIM*sizeof(double);
+  loc_stride[0] = PX*sizeof(double);
+
+  /* Each rank uses its own patch origin, so patches from different ranks don't
+   * overlap when nranks is small. */
+  for (p = 0; p < nranks; p++) {
+    desc[p].src_ptr       = &buffer[p][(rank % 3)*XDIM + (rank % 2)*PX];
+    desc[p].src_stride_ar = rem_stride;
+    desc[p].dst_ptr       = &local[p*PX*PY];
+    desc[p].dst_stride_ar = loc_stride;
+    desc[p].count         = count;
+    desc[p].stride_levels = 1;
+    desc[p].proc          = p;
+  }
+
+  ARMCI_Barrier();
+
+  /* Get the patch from every rank */
+  ARMCIX_GetS_multi(desc, nranks);
+
+  for (p = 0; p < nranks; p++)
+    for (y = 0; y < PY; y++)
+      for (x = 0; x < PX; x++) {
+        const double expected = value(p, (rank % 2)*PX + x, rank % 3 + y);
+        const double actual   = local[p*PX*PY + y*PX + x];
+
+        if (actual != expected) {
+          printf("%d: Get validation failed from %d at [%d, %d] expected=%f actual=%f\n",
+                 rank, p, y, x, expected, actual);
+          errors++;
+        }
+      }
+
+  ARMCI_Barrier();
+
+  /* Put back a negated patch, then add twice the original: remote = original */
+  for (p = 0; p < nranks; p++) {
+    void *tmp = desc[p].src_ptr;
+    desc[p].src_ptr       = desc[p].dst_ptr;
+    desc[p].src_stride_ar = loc_stride;
+    desc[p].dst_ptr       = tmp;
+    desc[p].dst_stride_ar = rem_stride;
+  }
+
+  for (i = 0; i < nranks*PX*PY; i++)
+    local[i] = -local[i];
+
+  if (rank == 0) {
+    ARMCIX_PutS_multi(desc, nranks);
+    ARMCI_AllFence();
+
+    for (i = 0; i < nranks*PX*PY; i++)
+      local[i] = -local[i];
+
+    ARMCIX_AccS_multi(ARMCI_ACC_DBL, &two, desc, nranks);
+  }
+
+  ARMCI_Barrier();
+
+  ARMCI_Access_begin(buffer[rank]);
+  for (y = 0; y < YDIM; y++)
+    for (x = 0; x < XDIM; x++) {
+      const double expected = value(rank, x, y);
+      const double actual   = buffer[rank][y*XDIM + x];
+
+      if (actual != expected) {
+        printf("%d: Put/Acc validation failed at [%d, %d] expected=%f actual=%f\n",
+               rank, y, x, expected, actual);
+        errors++;
+      }
+    }
+  ARMCI_Access_end(buffer[rank]);
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Free(buffer[rank]);
+  ARMCI_Free_local(local);
+  free(buffer);
+  free(desc);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) 2010. See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <armci.h>
+#include <armcix.h>
+
+#define NHDL 8
+#define N    256
+
+/* Pipeline blocks of gets on separate handles and complete them with
+ * ARMCIX_Waitany, ARMCIX_Testsome and ARMCIX_Waitsome.  Some handles carry
+ * several operations and one is never used. */
+
+static int check(int *buf, int peer, int blk, int rank, const char *name) {
+  int i, errors = 0;
+
+  for (i = 0; i < N; i++) {
+    if (buf[i] != peer*NHDL*N + blk*N + i) {
+      printf("%d: %s validation failed block %d at %d expected=%d actual=%d\n",
+             rank, name, blk, i, peer*NHDL*N + blk*N + i, buf[i]);
+      errors++;
+    }
+    buf[i] = -1;
+  }
+
+  return errors;
+}
+
+/* Post the gets of each block on its own handle.  Handle NHDL-1 stays
+ * inactive and odd handles get their block in several pieces. */
+static void post_gets(armci_hdl_t handles[], int **base, int *loc, int peer, int done[]) {
+  int h, i;
+
+  for (h = 0; h < NHDL; h++) {
+    ARMCI_INIT_HANDLE(&handles[h]);
+    done[h] = 0;
+
+    if (h == NHDL-1)
+      continue;
+
+    if (h % 2 == 0)
+      ARMCI_NbGet(base[peer] + h*N, loc + h*N, N*sizeof(int), peer, &handles[h]);
+    else
+      for (i = 0; i < N; i += N/8)
+        ARMCI_NbGet(base[peer] + h*N + i, loc + h*N + i, N/8*sizeof(int), peer, &handles[h]);
+  }
+}
+
+/* Every active handle must have completed exactly once */
+static int check_done(int done[], int rank, const char *name) {
+  int h, errors = 0;
+
+  for (h = 0; h < NHDL-1; h++) {
+    if (done[h] != 1) {
+      printf("%d: %s completed handle %d %d times\n", rank, name, h, done[h]);
+      errors++;
+    }
+  }
+
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  int          rank, nranks, peer, i, errors = 0;
+  int        **base;
+  int         *loc;
+  int          done[NHDL], indices[NHDL], outcount, index;
+  armci_hdl_t  handles[NHDL];
+
+  MPI_Init(&argc, &argv);
+  ARMCI_Init();
+
+  MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+  MPI_Comm_size(MPI_COMM_WORLD, &nranks);
+
+  if (rank == 0)
+    printf("ARMCI Waitany/Waitsome/Testsome Test:\n");
+
+  base = malloc(nranks*sizeof(int*));
+  ARMCI_Malloc((void**) base, NHDL*N*sizeof(int));
+
+  ARMCI_Access_begin(base[rank]);
+  for (i = 0; i < NHDL*N; i++)
+    base[rank][i] = rank*NHDL*N + i;
+  ARMCI_Access_end(base[rank]);
+
+  loc  = ARMCI_Malloc_local(NHDL*N*sizeof(int));
+  peer = (rank + 1) % nranks;
+
+  ARMCI_Barrier();
+
+  post_gets(handles, base, loc, peer, done);
+
+  for (;;) {
+    ARMCIX_Waitany(NHDL, handles, &index);
+    if (index < 0) break;
+
+    if (index == NHDL-1 || done[index]) {
+      printf("%d: Waitany returned bad index %d\n", rank, index);
+      errors++;
+      break;
+    }
+
+    done[index]++;
+    errors += check(loc + index*N, peer, index, rank, "Waitany");
+  }
+
+  errors += check_done(done, rank, "Waitany");
+
+  /* Testsome, which is refused without RMA requests */
+  post_gets(handles, base, loc, peer, done);
+
+#ifdef USE_RMA_REQUESTS
+  for (;;) {
+    ARMCIX_Testsome(NHDL, handles, &outcount, indices);
+    if (outcount < 0) break;
+
+    for (i = 0; i < outcount; i++) {
+      done[indices[i]]++;
+      errors += check(loc + indices[i]*N, peer, indices[i], rank, "Testsome");
+    }
+  }
+
+  errors += check_done(done, rank, "Testsome");
+#else
+  if (ARMCIX_Testsome(NHDL, handles, &outcount, indices) == 0 || outcount != 0) {
+    printf("%d: Testsome was not refused without RMA requests\n", rank);
+    errors++;
+  }
+
+  for (i = 0; i < NHDL-1; i++)
+    ARMCI_Wait(&handles[i]);
+#endif
+
+  /* Waitsome */
+  post_gets(handles, base, loc, peer, done);
+
+  for (;;) {
+    ARMCIX_Waitsome(NHDL, handles, &outcount, indices);
+    if (outcount < 0) break;
+
+    if (outcount == 0) {
+      printf("%d: Waitsome completed no handles\n", rank);
+      errors++;
+      break;
+    }
+
+    for (i = 0; i < outcount; i++) {
+      done[indices[i]]++;
+      errors += check(loc + indices[i]*N, peer, indices[i], rank, "Waitsome");
+    }
+  }
+
+  errors += check_done(done, rank, "Waitsome");
+
+  armci_msg_igop(&errors, 1, "+");
+
+  ARMCI_Barrier();
+
+  ARMCI_Free(base[rank]);
+  ARMCI_Free_local(loc);
+  free(base);
+
+  ARMCI_Finalize();
+  MPI_Finalize();
+
+  if (errors == 0) {
+    if (rank == 0) printf("Test complete: PASS.\n");
+    return 0;
+  }
+  else {
+    if (rank == 0) printf("Test complete: FAIL.\n");
+    return 1;
+  }
+}